@@ -0,0 +1,260 @@
+#include "../src/ising.hpp"
+#include "../src/montecarlo.hpp"
+#include "../src/checkerboard.hpp"
+#include "../src/multispin.hpp"
+#include "../src/domain.hpp"
+#include "../src/parallel.hpp"
+#include "../src/kernels.hpp"
+#include "../src/hypercube.hpp"
+#include "../src/heatbath.hpp"
+#include "../src/nfold.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Mesure des performances des noyaux Monte-Carlo et des fonctions d'observables (make bench).
+// Pour chaque noyau, taille de réseau et température (sous, à et au-dessus de Tc), le noyau est itéré pendant au moins
+// --time secondes. Résultat : une ligne "noyau;L;T;flips/ns;balayages/s" par mesure, sur la sortie standard ou --output.
+// Pour les noyaux Monte-Carlo, flips/ns compte les mises à jour de spin tentées (sites du cluster construit pour Wolff, même rejeté) ;
+// pour les observables, les sites parcourus (appels pour swappingEnergy).
+// Avec --baseline, chaque mesure est comparée à celle du fichier de référence : une baisse de débit de plus de
+// --tolerance (10% par défaut) est signalée par REGRESSION sur std::cerr et le programme se termine avec le code 1.
+//
+// Options : --sizes 16,64,256  --time 0.25  --output bench.csv  --baseline ref.csv  --tolerance 0.1
+
+typedef void (*Iterator)(Ising::Lattice&, MC::Parameters&, double&, double&);
+
+/// @brief Un noyau Monte-Carlo à mesurer.
+struct Kernel {
+    const char *name;
+    Iterator iterator;
+    // Mises à jour tentées par itération : 0 pour une mise à jour de spin unique, 1 pour un balayage complet,
+    // -1 pour un cluster de Wolff (lat.clusterSize, le cluster rejeté comptant aussi)
+    int updates;
+};
+
+/// @brief Résultat d'une mesure.
+struct Result {
+    std::string kernel;
+    uint size;
+    double T;
+    double flipsPerNs;
+    double sweepsPerSecond;
+};
+
+static const double Tc = 2 / std::log(1 + std::sqrt(2.0));
+
+static double elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Réseau de départ : ordonné sous Tc (état d'équilibre proche), aléatoire sinon.
+static Ising::Lattice startLattice(uint L, double T) {
+    Ising::Lattice lat = Ising::lattice(L, L);
+    Ising::seed(lat, 12345, 0);
+    if (T < Tc) {
+        Ising::uniformSpin(lat, UP);
+    }
+    else {
+        Ising::randomSpin(lat, 0.5);
+    }
+    return lat;
+}
+
+static Result runKernel(const Kernel &kernel, uint L, double T, double minTime) {
+    Ising::Lattice lat = startLattice(L, T);
+    // * Sans itération donnée, l'instanciation spécialisée pour ce réseau est choisie comme dans une simulation.
+    const Iterator iterator = kernel.iterator != nullptr ? kernel.iterator : MC::specializedMetropolis(lat);
+    MC::Parameters options = MC::parameters(0, 1, 0, 0, iterator, T, 1, 0, 1);
+    options.threads = Parallel::hardwareThreads();
+    if (kernel.iterator == MC::multiSpinIteration) {
+        Ising::packLattice(lat);
+    }
+    if (kernel.iterator == MC::domainIteration) {
+        MC::domainPlace(lat, options.threads);
+    }
+
+    double deltaE = 0;
+    double deltaM = 0;
+    // * Echauffement : tables, espace de travail et caches.
+    iterator(lat, options, deltaE, deltaM);
+
+    double updates = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    // * Le chronomètre n'est lu que toutes les 2^k itérations pour ne pas mesurer l'horloge elle-même.
+    for (uint64_t batch = 1; seconds < minTime; batch = std::min<uint64_t>(2 * batch, 1 << 20)) {
+        for (uint64_t k = 0; k < batch; k++) {
+            iterator(lat, options, deltaE, deltaM);
+            updates += kernel.updates == 0 ? 1 : kernel.updates == 1 ? lat.siteCount : lat.clusterSize;
+        }
+        seconds = elapsed(start);
+    }
+
+    Ising::freeLattice(lat);
+    return { kernel.name, L, T, updates / (seconds * 1e9), updates / lat.siteCount / seconds };
+}
+
+/// @brief Mesure une fonction d'observable appelée sur tout le réseau (ou site par site pour swappingEnergy).
+static Result runObservable(const std::string &name, uint L, double T, double minTime) {
+    Ising::Lattice lat = startLattice(L, T);
+    volatile double sink = 0;
+    double sites = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+
+    while (seconds < minTime) {
+        if (name == "latticeEnergy") {
+            sink = sink + Ising::latticeEnergy(lat, 1, 0.1);
+        }
+        else if (name == "magnetization") {
+            sink = sink + Ising::magnetization(lat);
+        }
+        else {
+            for (uint i = 0; i < lat.siteCount; i++) {
+                sink = sink + Ising::swappingEnergy(lat, i, 1, 0.1);
+            }
+        }
+        sites += lat.siteCount;
+        seconds = elapsed(start);
+    }
+
+    Ising::freeLattice(lat);
+    return { name, L, T, sites / (seconds * 1e9), sites / lat.siteCount / seconds };
+}
+
+static std::string key(const std::string &kernel, uint size, double T) {
+    std::ostringstream ss;
+    ss << kernel << ";" << size << ";" << T;
+    return ss.str();
+}
+
+/// @brief Lit un fichier de résultats : clé "noyau;L;T" vers flips/ns.
+static std::map<std::string, double> readBaseline(const std::string &fileName) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(fileName);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        // * Les trois premiers champs forment la clé, le quatrième est le débit.
+        size_t cut = 0;
+        for (int field = 0; field < 3 && cut != std::string::npos; field++) {
+            cut = line.find(';', cut + (field > 0));
+        }
+        if (cut != std::string::npos) {
+            baseline[line.substr(0, cut)] = std::stod(line.substr(cut + 1));
+        }
+    }
+    return baseline;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<uint> sizes = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    double minTime = 0.25;
+    double tolerance = 0.1;
+    std::string output;
+    std::string baselineFile;
+
+    for (int a = 1; a + 1 < argc; a += 2) {
+        const std::string option = argv[a];
+        const std::string value = argv[a + 1];
+        if (option == "--sizes") {
+            sizes.clear();
+            std::istringstream list(value);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                sizes.push_back(std::stoul(item));
+            }
+        }
+        else if (option == "--time") {
+            minTime = std::stod(value);
+        }
+        else if (option == "--output") {
+            output = value;
+        }
+        else if (option == "--baseline") {
+            baselineFile = value;
+        }
+        else if (option == "--tolerance") {
+            tolerance = std::stod(value);
+        }
+        else {
+            std::cerr << "Unknown option " << option << "\n";
+            return 2;
+        }
+    }
+
+    const Kernel kernels[] = {
+        { "metropolisIteration", MC::metropolisIteration, 0 },
+        { "metropolisSpecialized", nullptr, 0 },
+        { "wolffIteration", MC::wolffIteration, -1 },
+        { "swendsenWangIteration", MC::swendsenWangIteration, 1 },
+        { "checkerboardIteration", MC::checkerboardIteration, 1 },
+        { "multiSpinIteration", MC::multiSpinIteration, 1 },
+        { "domainIteration", MC::domainIteration, 1 },
+        { "heatBathIteration", MC::heatBathIteration, 0 },
+        { "heatBathSweepIteration", MC::heatBathSweepIteration, 1 },
+        { "nFoldIteration", MC::nFoldIteration, 0 },
+        // * Noyaux hypercubiques sur le même réseau 2D : coût du calcul des voisins par pas plutôt que par table.
+        { "hypercubeMetropolisIteration", MC::hypercubeMetropolisIteration, 0 },
+        { "hypercubeWolffIteration", MC::hypercubeWolffIteration, -1 },
+        { "hypercubeCheckerboardIteration", MC::hypercubeCheckerboardIteration, 1 },
+    };
+    const char *observables[] = { "latticeEnergy", "magnetization", "swappingEnergy" };
+    const double temperatures[] = { 1.5, Tc, 3.5 };
+
+    std::vector<Result> results;
+    for (uint L : sizes) {
+        for (double T : temperatures) {
+            for (const Kernel &kernel : kernels) {
+                // * Le codage multi-spin demande des lignes d'un multiple de 64 sites.
+                if (kernel.iterator == MC::multiSpinIteration && L % 64 != 0) {
+                    continue;
+                }
+                results.push_back(runKernel(kernel, L, T, minTime));
+                std::cerr << "[Bench] " << results.back().kernel << " L = " << L << " T = " << T << "\n";
+            }
+            for (const char *name : observables) {
+                results.push_back(runObservable(name, L, T, minTime));
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+    }
+    std::ostream &out = output.empty() ? std::cout : file;
+    out << "# kernel;L;T;flipsPerNs;sweepsPerSecond\n";
+    for (const Result &r : results) {
+        out << key(r.kernel, r.size, r.T) << ";" << r.flipsPerNs << ";" << r.sweepsPerSecond << "\n";
+    }
+
+    if (baselineFile.empty()) {
+        return 0;
+    }
+
+    const std::map<std::string, double> baseline = readBaseline(baselineFile);
+    int regressions = 0;
+    for (const Result &r : results) {
+        auto reference = baseline.find(key(r.kernel, r.size, r.T));
+        if (reference == baseline.end()) {
+            continue;
+        }
+        const double ratio = r.flipsPerNs / reference->second;
+        if (ratio < 1 - tolerance) {
+            std::cerr << "REGRESSION " << key(r.kernel, r.size, r.T) << " " << reference->second << " -> " << r.flipsPerNs << " flips/ns (x" << ratio << ")\n";
+            regressions++;
+        }
+    }
+    std::cerr << "[Bench] " << regressions << " regression(s) against " << baselineFile << "\n";
+    return regressions > 0;
+}
@@ -0,0 +1,451 @@
+#include "batch.hpp"
+#include "parallel.hpp"
+#include "checkerboard.hpp"
+#include "kernels.hpp"
+#include "hypercube.hpp"
+#include "heatbath.hpp"
+#include "nfold.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+namespace Batch {
+
+/// @brief Nombre de points entre deux points de reprise d'une tâche.
+#define CHECKPOINT_INTERVAL 5
+
+typedef void (*Iterator)(Ising::Lattice&, MC::Parameters&, double&, double&);
+
+/// @brief Algorithme utilisable dans un fichier de tâches. square est l'itération pour un réseau 2D, hypercube pour
+/// les autres dimensions (nullptr : non disponible). Les durées par défaut sont celles de main() ; pour un algorithme
+/// à un site par itération (perSite), elles sont en balayages et multipliées par le nombre de sites.
+struct Algorithm {
+    const char *name;
+    Iterator square;
+    Iterator hypercube;
+    double epochs;
+    double jump;
+    double duration;
+    bool perSite;
+};
+
+static const Algorithm algorithms[] = {
+    { "metropolis", MC::metropolisIteration, MC::hypercubeMetropolisIteration, 10000, 600, 0.5, true },
+    { "wolff", MC::wolffIteration, MC::hypercubeWolffIteration, 500, 100, 2, false },
+    { "swendsenWang", MC::swendsenWangIteration, nullptr, 20000, 1000, 0.5, false },
+    { "checkerboard", MC::checkerboardIteration, MC::hypercubeCheckerboardIteration, 20000, 1000, 0.5, false },
+    { "heatBath", MC::heatBathIteration, MC::heatBathIteration, 10000, 600, 0.5, true },
+    { "heatBathSweep", MC::heatBathSweepIteration, MC::heatBathSweepIteration, 20000, 1000, 0.5, false },
+    { "nFold", MC::nFoldIteration, MC::nFoldIteration, 20000, 1000, 0.5, false },
+};
+
+static const Algorithm *algorithm(const std::string &name) {
+    for (const Algorithm &a : algorithms) {
+        if (name == a.name) {
+            return &a;
+        }
+    }
+    return nullptr;
+}
+
+/// @brief Lit un réel, la chaîne entière devant être consommée.
+static bool number(const std::string &text, double &value) {
+    char *end;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+/// @brief Plus grande graine représentable, exclue (2^64).
+#define SEED_LIMIT 18446744073709551616.0
+
+/// @brief Lit un entier de [0, limit) : la conversion vers un type entier n'est sûre qu'après ce test.
+static bool integer(const std::string &text, double limit, double &value) {
+    return number(text, value) && value >= 0 && value < limit && value == std::floor(value);
+}
+
+/// @brief Découpe "a,b,c" en valeurs ; pour integers, "a..b" donne tous les entiers de a à b.
+static bool list(const std::string &text, std::vector<std::string> &values, bool integers) {
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        const size_t dots = item.find("..");
+        double first, last;
+        if (integers && dots != std::string::npos) {
+            if (!integer(item.substr(0, dots), SEED_LIMIT, first) || !integer(item.substr(dots + 2), SEED_LIMIT, last) || last < first) {
+                return false;
+            }
+            for (double k = first; k <= last; k++) {
+                values.push_back(std::to_string((uint64_t)k));
+            }
+        }
+        else if (!item.empty()) {
+            values.push_back(item);
+        }
+    }
+    return !values.empty();
+}
+
+/// @brief Vérifie qu'une tâche est réalisable, avant de lancer quoi que ce soit.
+static bool validate(const Job &job, std::string &error) {
+    const Algorithm *a = algorithm(job.algorithm);
+    if (a == nullptr) {
+        error = "unknown algorithm " + job.algorithm;
+    }
+    else if (job.L < 2 || job.dimension < 1 || job.dimension > Ising::MAX_DIMENSION) {
+        error = "L must be at least 2 and dimension between 1 and " + std::to_string(Ising::MAX_DIMENSION);
+    }
+    else if ((job.dimension == 2 ? a->square : a->hypercube) == nullptr) {
+        error = job.algorithm + " is not available in dimension " + std::to_string(job.dimension);
+    }
+    else if (job.algorithm == "checkerboard" && (job.dimension < 2 || job.L % 2 != 0)) {
+        // * Il faut deux couleurs sur au moins deux axes : hypercubeCheckerboardIteration refuse la dimension 1.
+        error = "checkerboard needs dimension >= 2 and an even L";
+    }
+    else if (job.algorithm == "swendsenWang" && (job.variable == Checkpoint::FIELD || job.h != 0)) {
+        error = "swendsenWang needs h = 0";
+    }
+    else if (job.points < 2) {
+        error = "points must be at least 2";
+    }
+    else if (job.variable == Checkpoint::TEMPERATURE ? std::min(job.from, job.to) <= 0 : job.T <= 0) {
+        error = "temperatures must be positive";
+    }
+    else {
+        return true;
+    }
+    return false;
+}
+
+bool parse(const std::string &line, std::vector<Job> &jobs, std::string &error) {
+    std::stringstream stream(line.substr(0, line.find('#')));
+    std::string token;
+
+    Job base = Job();
+    base.variable = Checkpoint::TEMPERATURE;
+    base.points = 100;
+    base.J = 1;
+    base.kB = 1;
+    base.variation = 0.0002;
+    base.targetError = 0.005;
+    bool from = false, to = false;
+    std::vector<std::string> L, dimension = { "2" }, algorithm = { "metropolis" }, seed = { "1" }, T = { "4" }, h = { "0" };
+    double value;
+    bool empty = true;
+
+    while (stream >> token) {
+        empty = false;
+        const size_t equal = token.find('=');
+        const std::string key = token.substr(0, equal);
+        const std::string text = equal == std::string::npos ? "" : token.substr(equal + 1);
+        std::vector<std::string> *values = key == "L" ? &L : key == "dimension" ? &dimension : key == "algorithm" ? &algorithm
+            : key == "seed" ? &seed : key == "T" ? &T : key == "h" ? &h : nullptr;
+        double *scalar = key == "from" ? &base.from : key == "to" ? &base.to : key == "J" ? &base.J : key == "kB" ? &base.kB
+            : key == "epochs" ? &base.epochs : key == "jump" ? &base.jump : key == "duration" ? &base.duration
+            : key == "variation" ? &base.variation : key == "targetError" ? &base.targetError : nullptr;
+
+        if (values != nullptr) {
+            values->clear();
+            if (!list(text, *values, key == "seed")) {
+                error = "invalid list in " + token;
+                return false;
+            }
+        }
+        else if (scalar != nullptr || key == "points") {
+            if (scalar != nullptr ? !number(text, value) : !integer(text, (double)UINT_MAX + 1, value)) {
+                error = "invalid number in " + token;
+                return false;
+            }
+            if (scalar != nullptr) {
+                *scalar = value;
+            }
+            else {
+                base.points = value;
+            }
+            from |= key == "from";
+            to |= key == "to";
+        }
+        else if (key == "sweep" && (text == "T" || text == "h")) {
+            base.variable = text == "T" ? Checkpoint::TEMPERATURE : Checkpoint::FIELD;
+        }
+        else if (key == "name" && !text.empty() && text.find('/') == std::string::npos) {
+            base.name = text;
+        }
+        else {
+            error = "unknown or invalid entry " + token;
+            return false;
+        }
+    }
+    if (empty) {
+        return true;
+    }
+    if (L.empty()) {
+        error = "missing L";
+        return false;
+    }
+    // * Balayages par défaut de main() : T de 0.1 à 5, h de -5 à 5.
+    if (!from) {
+        base.from = base.variable == Checkpoint::TEMPERATURE ? 0.1 : -5;
+    }
+    if (!to) {
+        base.to = 5;
+    }
+
+    // * Produit cartésien des listes ; rien n'est ajouté si une seule combinaison est invalide.
+    std::vector<Job> expanded;
+    for (const std::string &l : L) for (const std::string &d : dimension) for (const std::string &a : algorithm)
+    for (const std::string &t : T) for (const std::string &f : h) for (const std::string &s : seed) {
+        Job job = base;
+        double size, dim, temperature, field, index;
+        if (!integer(l, (double)UINT_MAX + 1, size) || !integer(d, Ising::MAX_DIMENSION + 1, dim) || !number(t, temperature)
+            || !number(f, field) || !integer(s, SEED_LIMIT, index)) {
+            error = "invalid value in L, dimension (at most " + std::to_string(Ising::MAX_DIMENSION) + "), T, h or seed";
+            return false;
+        }
+        job.L = size;
+        job.dimension = dim;
+        job.algorithm = a;
+        job.T = temperature;
+        job.h = field;
+        job.seed = index;
+        if (!validate(job, error)) {
+            error += " (" + identifier(job) + ")";
+            return false;
+        }
+        expanded.push_back(job);
+    }
+    jobs.insert(jobs.end(), expanded.begin(), expanded.end());
+    return true;
+}
+
+bool read(const std::string &fileName, std::vector<Job> &jobs) {
+    std::ifstream file(fileName);
+    if (!file) {
+        std::cerr << "[Batch] Cannot open " << fileName << "\n";
+        return false;
+    }
+    std::string line, error;
+    for (uint number = 1; std::getline(file, line); number++) {
+        if (!parse(line, jobs, error)) {
+            std::cerr << "[Batch] " << fileName << ":" << number << ": " << error << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string identifier(const Job &job) {
+    std::ostringstream id;
+    id << std::setprecision(10);
+    if (!job.name.empty()) {
+        id << job.name << "-";
+    }
+    id << "L" << job.L << "-d" << job.dimension << "-" << job.algorithm;
+    if (job.variable == Checkpoint::TEMPERATURE) {
+        id << "-T" << job.from << "to" << job.to << "n" << job.points << "-h" << job.h;
+    }
+    else {
+        id << "-h" << job.from << "to" << job.to << "n" << job.points << "-T" << job.T;
+    }
+    // * Les paramètres avancés n'apparaissent que s'ils diffèrent des valeurs par défaut de parse.
+    if (job.J != 1) id << "-J" << job.J;
+    if (job.kB != 1) id << "-kB" << job.kB;
+    if (job.epochs != 0) id << "-epochs" << job.epochs;
+    if (job.jump != 0) id << "-jump" << job.jump;
+    if (job.duration != 0) id << "-duration" << job.duration;
+    if (job.variation != 0.0002) id << "-variation" << job.variation;
+    if (job.targetError != 0.005) id << "-err" << job.targetError;
+    id << "-seed" << job.seed;
+    return id.str();
+}
+
+bool writeProps(const std::string &fileName, const Ising::Lattice &lat, double kB, const MC::Properties &props, uint samplingPoints) {
+    std::fstream file;
+    file.open(fileName, std::ios::out);
+    if (!file) {
+        std::cerr << "[Batch] Cannot open " << fileName << "\n";
+        return false;
+    }
+
+    double norm, nr2;
+
+    for (uint i = 0; i < samplingPoints; i++)
+    {
+        norm = 1/(lat.sizeXY * lat.neighborCount * props.samples[i]);
+        nr2 = norm / props.samples[i];
+        file << props.T[i] << ";";
+        file << norm * props.E[i]<< ";";
+        file << norm * props.E_sq[i]<< ";";
+        file << norm * props.M[i] << ";";
+        file << norm * props.M_sq[i] << ";";
+        file << norm * props.M_abs[i] << ";";
+        file << (norm * props.E_sq[i] - nr2 * props.E[i] * props.E[i]) / (kB * props.T[i]) / (kB * props.T[i]) << ";";
+        file << (norm * props.M_sq[i] - nr2 * props.M[i] * props.M[i]) / (kB * props.T[i]) << ";";
+        // * Barres d'erreur sur <E> et <|M|>, et temps d'autocorrélation (nuls si options.targetError = 0)
+        file << props.E_err[i] / (lat.sizeXY * lat.neighborCount) << ";";
+        file << props.M_abs_err[i] / (lat.sizeXY * lat.neighborCount) << ";";
+        file << props.tau[i] << "\n";
+    }
+    file.close();
+    return !file.fail();
+}
+
+static bool exists(const std::string &fileName) {
+    return access(fileName.c_str(), F_OK) == 0;
+}
+
+/// @brief Paramètres de simulation d'une tâche, pour un réseau déjà construit.
+static MC::Parameters options(const Job &job, const Ising::Lattice &lat) {
+    const Algorithm *a = algorithm(job.algorithm);
+    const double scale = a->perSite ? lat.siteCount : 1;
+    const double epochs = job.epochs > 0 ? job.epochs : a->epochs * scale;
+    const double jump = job.jump > 0 ? job.jump : a->jump * scale;
+    const double duration = job.duration > 0 ? job.duration : a->duration;
+
+    // * Metropolis : instanciation spécialisée pour la géométrie, enregistrée comme la version générique par Checkpoint.
+    const Iterator iterator = job.algorithm == "metropolis" ? MC::specializedMetropolis(lat) : job.dimension == 2 ? a->square : a->hypercube;
+    MC::Parameters options = MC::parameters(std::min(epochs, (double)UINT_MAX), std::min(jump, (double)UINT_MAX), duration, job.variation, iterator, job.T, job.J, job.h, job.kB);
+    options.seed = job.seed;
+    options.targetError = job.targetError;
+    if (iterator == MC::nFoldIteration) {
+        options.iterationSteps = lat.siteCount;
+    }
+    return options;
+}
+
+Status run(const Job &job, const std::string &directory) {
+    const std::string base = directory + "/" + identifier(job);
+
+    // * La réservation est le verrou lui-même : il est libéré par le noyau si le processus meurt, sans réservation
+    // * orpheline à nettoyer. Le fichier de résultat n'est testé qu'une fois le verrou obtenu.
+    const int fd = open((base + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "[Batch] Cannot open " << base << ".lock\n";
+        return FAILED;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return BUSY;
+    }
+    if (exists(base + ".csv")) {
+        unlink((base + ".lock").c_str());
+        close(fd);
+        return SKIPPED;
+    }
+
+    Ising::Lattice lat = Ising::hypercube(job.L, job.dimension);
+    Ising::seed(lat, job.seed, 0);
+    Ising::randomSpin(lat, 0.5);
+    MC::Parameters opts = options(job, lat);
+
+    MC::Properties props = job.variable == Checkpoint::TEMPERATURE
+        ? Checkpoint::thermalizeLattice(lat, opts, job.from, job.to, job.points, base + ".ckp", CHECKPOINT_INTERVAL)
+        : Checkpoint::magnetizeLattice(lat, opts, job.from, job.to, job.points, base + ".ckp", CHECKPOINT_INTERVAL);
+
+    // * Le résultat n'apparaît sous son nom qu'une fois complet : sa présence marque la tâche comme terminée.
+    const bool written = writeProps(base + ".csv.tmp", lat, opts.kB, props, job.points)
+        && rename((base + ".csv.tmp").c_str(), (base + ".csv").c_str()) == 0;
+    if (written) {
+        unlink((base + ".ckp").c_str());
+        unlink((base + ".lock").c_str());
+    }
+    close(fd);
+
+    MC::freeProperties(props);
+    Ising::freeLattice(lat);
+    return written ? DONE : FAILED;
+}
+
+/// @brief Etat d'une tâche pour --list, sans la réserver.
+static const char *state(const Job &job, const std::string &directory) {
+    const std::string base = directory + "/" + identifier(job);
+    if (exists(base + ".csv")) {
+        return "done";
+    }
+    const int fd = open((base + ".lock").c_str(), O_RDONLY);
+    if (fd >= 0) {
+        const bool locked = flock(fd, LOCK_SH | LOCK_NB) != 0;
+        close(fd);
+        if (locked) {
+            return "running";
+        }
+    }
+    return exists(base + ".ckp") ? "partial" : "pending";
+}
+
+int main(int argc, char *argv[]) {
+    uint threads = Parallel::hardwareThreads();
+    std::string directory = "res/jobs";
+    bool listOnly = false;
+    std::vector<Job> jobs;
+    std::string error;
+
+    for (int k = 1; k < argc; k++) {
+        const std::string arg = argv[k];
+        const bool hasValue = k + 1 < argc;
+        if (arg == "--threads" && hasValue) {
+            threads = std::max(1, atoi(argv[++k]));
+        }
+        else if (arg == "--output" && hasValue) {
+            directory = argv[++k];
+        }
+        else if (arg == "--job" && hasValue) {
+            if (!parse(argv[++k], jobs, error)) {
+                std::cerr << "[Batch] --job: " << error << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--list") {
+            listOnly = true;
+        }
+        else if (arg.rfind("--", 0) == 0 || !read(arg, jobs)) {
+            std::cerr << "Usage: " << argv[0] << " [--threads N] [--output dir] [--list] [--job \"key=value ...\"] jobfile...\n";
+            return 1;
+        }
+    }
+
+    // * Une même tâche décrite deux fois n'est exécutée qu'une fois.
+    std::set<std::string> seen;
+    std::vector<Job> unique;
+    for (const Job &job : jobs) {
+        if (seen.insert(identifier(job)).second) {
+            unique.push_back(job);
+        }
+    }
+
+    std::error_code status;
+    std::filesystem::create_directories(directory, status);
+    if (status) {
+        std::cerr << "[Batch] Cannot create " << directory << "\n";
+        return 1;
+    }
+
+    if (listOnly) {
+        for (const Job &job : unique) {
+            std::cout << state(job, directory) << "\t" << identifier(job) << "\n";
+        }
+        return 0;
+    }
+
+    std::atomic<uint> count[4] = {};
+    const char *labels[4] = { "done", "skipped (already done)", "busy (claimed elsewhere)", "FAILED" };
+    Parallel::forEach(unique.size(), std::min<uint>(threads, std::max<size_t>(1, unique.size())), [&](uint k, uint worker) {
+        const Status result = run(unique[k], directory);
+        count[result]++;
+        std::cout << ("[Batch] " + identifier(unique[k]) + ": " + labels[result] + "\n");
+    });
+
+    std::cout << "[Batch] " << unique.size() << " job(s): " << count[DONE] << " done, " << count[SKIPPED] << " skipped, "
+              << count[BUSY] << " busy, " << count[FAILED] << " failed\n";
+    return count[FAILED] > 0;
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+#include "checkpoint.hpp"
+
+#include <string>
+#include <vector>
+
+// Exécution par lots : des fichiers de tâches décrivent des balayages en T ou en h, une tâche par ligne sous la forme
+// "clé=valeur" (voir parse), sans recompiler. Les listes "a,b,c" (et les intervalles d'entiers "a..b" pour seed) sont
+// développées en produit cartésien : une ligne peut décrire des centaines de tâches.
+// Les tâches sont réparties sur les coeurs ; chacune est réservée par un verrou flock sur <dossier>/<id>.lock, si bien
+// que plusieurs processus lancés sur la même liste et le même dossier se partagent le travail sans coordination.
+// Une tâche terminée a son fichier <id>.csv (mêmes colonnes que saveProps, écrit puis renommé) et est sautée au
+// lancement suivant ; une tâche interrompue reprend à son dernier point de reprise <id>.ckp.
+// ! Les verrous flock ne sont fiables que sur un système de fichiers local.
+
+namespace Batch {
+
+/// @brief Paramètres d'une simulation du lot. Les valeurs nulles de epochs, jump et duration désignent les valeurs
+/// par défaut de l'algorithme.
+struct Job {
+    std::string name;
+    uint L;
+    uint dimension;
+    std::string algorithm;
+
+    // Balayage de from à to sur points points, à h fixé (TEMPERATURE) ou à T fixée (FIELD)
+    Checkpoint::Variable variable;
+    double from;
+    double to;
+    uint points;
+    double T;
+    double h;
+
+    double J;
+    double kB;
+    uint64_t seed;
+    double epochs;
+    double jump;
+    double duration;
+    double variation;
+    double targetError;
+};
+
+/// @brief Développe une ligne de fichier de tâches. Clés : L, dimension (2), algorithm (metropolis), sweep (T ou h),
+/// from, to, points (100), T (4, pour sweep=h), h (0, pour sweep=T), J (1), kB (1), seed (1), epochs, jump, duration,
+/// variation (0.0002), targetError (0.005), name (préfixe de l'identifiant). Tout ce qui suit # est ignoré.
+/// Algorithmes : metropolis, wolff, swendsenWang, checkerboard, heatBath, heatBathSweep, nFold.
+/// @param line Ligne à lire
+/// @param jobs Tâches (ajoutées à la fin)
+/// @param error Message en cas d'échec
+/// @return false si la ligne est invalide (jobs n'est alors pas modifié)
+bool parse(const std::string &line, std::vector<Job> &jobs, std::string &error);
+
+/// @brief Lit un fichier de tâches.
+/// @return false si le fichier est illisible ou contient une ligne invalide (message sur std::cerr)
+bool read(const std::string &fileName, std::vector<Job> &jobs);
+
+/// @brief Identifiant d'une tâche, fonction de tous ses paramètres : sert de nom aux fichiers de la tâche.
+std::string identifier(const Job &job);
+
+/// @brief Ecrit les propriétés d'un balayage, une ligne par point "T;E;E²;M;M²;|M|;C;χ;erreur E;erreur |M|;τ", par
+/// spin et par liaison. Pour un balayage en h, la première colonne contient h.
+/// @param fileName Chemin du fichier
+/// @param lat Réseau de spin simulé (seules ses dimensions sont lues)
+/// @param kB Constante de Boltzmann
+/// @param props Propriétés
+/// @param samplingPoints Nombre de points
+/// @return false si le fichier ne peut être écrit
+bool writeProps(const std::string &fileName, const Ising::Lattice &lat, double kB, const MC::Properties &props, uint samplingPoints);
+
+/// @brief Résultat de run pour une tâche.
+enum Status {
+    DONE = 0,
+    SKIPPED = 1,
+    BUSY = 2,
+    FAILED = 3
+};
+
+/// @brief Exécute une tâche si elle n'est ni terminée (SKIPPED) ni réservée par un autre thread ou processus (BUSY).
+/// @param job Tâche
+/// @param directory Dossier des fichiers de la tâche (existant)
+/// @return Statut de la tâche
+Status run(const Job &job, const std::string &directory);
+
+/// @brief Point d'entrée en ligne de commande :
+/// isingModel [--threads N] [--output dossier] [--list] [--job "clé=valeur ..."] fichier...
+/// Sans --threads, un thread par coeur ; le dossier par défaut est res/jobs. --list affiche l'état des tâches sans
+/// rien exécuter.
+/// @return Code de sortie (0 si aucune tâche n'a échoué)
+int main(int argc, char *argv[]);
+}
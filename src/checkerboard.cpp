@@ -0,0 +1,89 @@
+#include "checkerboard.hpp"
+
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+namespace MC {
+
+/// @brief Calcule l'indice dans la table d'acceptation de chaque site d'une ligne.
+static void rowIndices(const int8_t *row, const int8_t *above, const int8_t *below, const uint sizeX, int8_t *out) {
+    const uint last = sizeX - 1;
+    out[0] = tableIndex(row[last] + row[1] + above[0] + below[0], row[0]);
+
+    // * Sites intérieurs : les voisins x - 1 et x + 1 sont des chargements décalés, sans repliement.
+    uint x = 1;
+#if defined(__AVX512BW__)
+    const __m512i offset512 = _mm512_set1_epi8(Ising::MAX_NEIGHBORS);
+    const __m512i zero512 = _mm512_setzero_si512();
+    const __m512i one512 = _mm512_set1_epi8(1);
+    for (; x + 64 <= last; x += 64) {
+        __m512i field = _mm512_add_epi8(_mm512_loadu_si512(row + x - 1), _mm512_loadu_si512(row + x + 1));
+        field = _mm512_add_epi8(field, _mm512_add_epi8(_mm512_loadu_si512(above + x), _mm512_loadu_si512(below + x)));
+        __mmask64 isUp = _mm512_cmpgt_epi8_mask(_mm512_loadu_si512(row + x), zero512);
+        __m512i k = _mm512_add_epi8(field, offset512);
+        _mm512_storeu_si512(out + x, _mm512_mask_add_epi8(k, isUp, k, one512));
+    }
+#endif
+#if defined(__AVX2__)
+    const __m256i offset256 = _mm256_set1_epi8(Ising::MAX_NEIGHBORS);
+    const __m256i zero256 = _mm256_setzero_si256();
+    for (; x + 32 <= last; x += 32) {
+        __m256i field = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*)(row + x - 1)), _mm256_loadu_si256((const __m256i*)(row + x + 1)));
+        field = _mm256_add_epi8(field, _mm256_add_epi8(_mm256_loadu_si256((const __m256i*)(above + x)), _mm256_loadu_si256((const __m256i*)(below + x))));
+        // * cmpgt vaut -1 pour un spin UP : on le soustrait pour ajouter 1.
+        __m256i isUp = _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(row + x)), zero256);
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_sub_epi8(_mm256_add_epi8(field, offset256), isUp));
+    }
+#endif
+    for (; x < last; x++) {
+        out[x] = tableIndex(row[x - 1] + row[x + 1] + above[x] + below[x], row[x]);
+    }
+
+    out[last] = tableIndex(row[last - 1] + row[0] + above[last] + below[last], row[last]);
+}
+
+void checkerboardRow(int8_t *row, const int8_t *above, const int8_t *below, const uint sizeX, const uint parity, const AcceptanceTable &table, RNG::Generator &rng, int8_t *buffer, double *random, double &deltaE, double &deltaM) {
+    // * Les champs des sites d'une couleur ne dépendent que des sites de l'autre couleur :
+    // * ils peuvent être calculés pour toute la ligne avant de retourner le moindre spin.
+    rowIndices(row, above, below, sizeX, buffer);
+    RNG::uniform(rng, random, sizeX / 2);
+
+    // * Acceptation sans branchement : un tirage par site, p = 1 est toujours accepté.
+    uint flips = 0;
+    for (uint j = 0, x = parity; x < sizeX; j++, x += 2) {
+        const int k = buffer[x];
+        const int flip = random[j] < table.probability[k];
+        flips += flip;
+        deltaE += flip * table.deltaE[k];
+        deltaM -= flip * 2 * row[x];
+        row[x] *= 1 - 2 * flip;
+    }
+    TELEMETRY_ADD(attempts, sizeX / 2);
+    TELEMETRY_ADD(accepted, flips);
+}
+
+void checkerboardIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(lat.sizeY > 1 && lat.sizeX % 2 == 0 && lat.sizeY % 2 == 0);
+    updateAcceptance(options);
+
+    deltaE = 0;
+    deltaM = 0;
+
+    std::vector<int8_t> buffer(lat.sizeX);
+    std::vector<double> random(lat.sizeX / 2);
+    const uint sizeX = lat.sizeX;
+    const uint sizeY = lat.sizeY;
+
+    for (uint color = 0; color < 2; color++) {
+        for (uint y = 0; y < sizeY; y++) {
+            int8_t *row = lat.spin + y * sizeX;
+            const int8_t *above = lat.spin + ((y + sizeY - 1) % sizeY) * sizeX;
+            const int8_t *below = lat.spin + ((y + 1) % sizeY) * sizeX;
+            checkerboardRow(row, above, below, sizeX, (y + color) & 1, options.table, lat.rng, buffer.data(), random.data(), deltaE, deltaM);
+        }
+    }
+}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Moteur de Metropolis par balayage en damier : tous les sites noirs ((x + y) pair) sont mis à jour,
+// puis tous les sites blancs. Les sites d'une même couleur n'ont aucun voisin commun, leurs champs locaux
+// peuvent donc être calculés ensemble par instructions SIMD (AVX-512 ou AVX2 si disponibles à la compilation,
+// boucle scalaire sinon).
+
+namespace MC {
+
+/// @brief Met à jour les sites d'une ligne dont l'abscisse a la parité donnée.
+/// @param row Ligne de spins à mettre à jour
+/// @param above Ligne voisine précédente (y - 1)
+/// @param below Ligne voisine suivante (y + 1)
+/// @param sizeX Longueur des lignes (paire)
+/// @param parity Parité de l'abscisse des sites à mettre à jour (0 ou 1)
+/// @param table Table d'acceptation à jour
+/// @param rng Flux aléatoire
+/// @param buffer Tampon de travail d'au moins sizeX octets
+/// @param random Tampon de travail d'au moins sizeX / 2 réels
+/// @param deltaE Variable où ajouter la différence d'énergie de la ligne
+/// @param deltaM Variable où ajouter la différence de magnétisation de la ligne
+void checkerboardRow(int8_t *row, const int8_t *above, const int8_t *below, const uint sizeX, const uint parity, const AcceptanceTable &table, RNG::Generator &rng, int8_t *buffer, double *random, double &deltaE, double &deltaM);
+
+/// @brief Effectue un balayage complet en damier (sizeXY tentatives de spin-flip) sur un réseau 2D de tailles paires.
+/// Une itération correspond donc à un balayage : epochThreshold et jumpSize s'expriment en balayages.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void checkerboardIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
@@ -0,0 +1,424 @@
+#include "checkpoint.hpp"
+#include "checkerboard.hpp"
+#include "multispin.hpp"
+#include "domain.hpp"
+#include "kernels.hpp"
+#include "hypercube.hpp"
+#include "heatbath.hpp"
+#include "nfold.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Checkpoint {
+
+/// @brief Version du format, à incrémenter à chaque modification de Header.
+#define CHECKPOINT_VERSION 3
+/// @brief Nombre de tableaux de MC::Properties enregistrés.
+#define PROPERTY_COLUMNS 11
+
+typedef void (*Iterator)(Ising::Lattice&, MC::Parameters&, double&, double&);
+typedef uint (*Equilibrator)(Ising::Lattice&, MC::Parameters&, double&, double&);
+
+// * Les pointeurs de fonction ne survivent pas à une recompilation : ils sont enregistrés par leur rang dans ces tables.
+// ! Ne jamais réordonner, seulement ajouter à la fin.
+static const Iterator iterators[] = {
+    MC::metropolisIteration,
+    MC::wolffIteration,
+    MC::swendsenWangIteration,
+    MC::checkerboardIteration,
+    MC::multiSpinIteration,
+    MC::domainIteration,
+    MC::hypercubeMetropolisIteration,
+    MC::hypercubeWolffIteration,
+    MC::hypercubeCheckerboardIteration,
+    MC::heatBathIteration,
+    MC::heatBathSweepIteration,
+    MC::nFoldIteration,
+};
+
+static const Equilibrator equilibrators[] = {
+    nullptr,
+    MC::gewekeEquilibrium,
+    MC::mserEquilibrium,
+    MC::hotColdEquilibrium,
+};
+
+/// @brief En-tête du fichier, suivi des PROPERTY_COLUMNS tableaux de samplingPoints réels puis des spins
+/// (mots de 64 bits, bit i % 64 du mot i / 64 à 1 pour un spin UP, comme Ising::packLattice).
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t packed;
+    uint32_t sizeX;
+    uint32_t sizeY;
+    uint32_t dimension;
+
+    int32_t iterator;
+    int32_t equilibrator;
+    uint32_t epochThreshold;
+    uint32_t jumpSize;
+    double dataRecordDuration;
+    double relativeVariation;
+    double J;
+    double h;
+    double T;
+    double kB;
+    uint64_t seed;
+    uint32_t threads;
+    double targetError;
+    double iterationSteps;
+
+    uint64_t rng[4];
+    double energy;
+    double magnetization;
+
+    uint32_t variable;
+    uint32_t samplingPoints;
+    uint32_t next;
+    double start;
+    double step;
+};
+
+static const char MAGIC[8] = { 'I', 'S', 'I', 'N', 'G', 'C', 'K', 'P' };
+
+// * Un écrivain par thread appelant : plusieurs balayages avec reprise peuvent tourner en parallèle (Batch).
+static thread_local std::thread writer;
+
+template <typename T, size_t N>
+static int32_t indexOf(const T (&table)[N], T value) {
+    for (size_t k = 0; k < N; k++) {
+        if (table[k] == value) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+static void columns(const MC::Properties &props, double *column[PROPERTY_COLUMNS]) {
+    double *all[PROPERTY_COLUMNS] = { props.T, props.E, props.E_sq, props.M, props.M_sq, props.M_abs, props.mcSteps, props.samples, props.E_err, props.M_abs_err, props.tau };
+    std::copy(all, all + PROPERTY_COLUMNS, column);
+}
+
+static size_t spinWords(const Header &header) {
+    return ((uint64_t)header.sizeX * header.sizeY + 63) / 64;
+}
+
+static size_t fileSize(const Header &header) {
+    return sizeof(Header) + sizeof(double) * PROPERTY_COLUMNS * header.samplingPoints + sizeof(uint64_t) * spinWords(header);
+}
+
+/// @brief Copie tout l'état dans un tampon contigu, image exacte du fichier.
+static std::vector<char> serialize(Ising::Lattice &lat, const MC::Parameters &options, const Sweep &sweep) {
+    Header header = Header();
+    std::copy(MAGIC, MAGIC + 8, header.magic);
+    header.version = CHECKPOINT_VERSION;
+    header.packed = lat.bits != nullptr;
+    header.sizeX = lat.sizeX;
+    header.sizeY = lat.sizeY;
+    header.dimension = lat.dimension;
+
+    // * Une itération spécialisée est enregistrée comme sa version générique.
+    header.iterator = indexOf(iterators, MC::genericIterator(options.mcIterator));
+    header.equilibrator = indexOf(equilibrators, options.equilibrator);
+    assert(header.iterator >= 0 && header.equilibrator >= 0);
+    header.epochThreshold = options.epochThreshold;
+    header.jumpSize = options.jumpSize;
+    header.dataRecordDuration = options.dataRecordDuration;
+    header.relativeVariation = options.relativeVariation;
+    header.J = options.J;
+    header.h = options.h;
+    header.T = options.T;
+    header.kB = options.kB;
+    header.seed = options.seed;
+    header.threads = options.threads;
+    header.targetError = options.targetError;
+    header.iterationSteps = options.iterationSteps;
+
+    std::copy(lat.rng.s, lat.rng.s + 4, header.rng);
+    header.energy = sweep.energy;
+    header.magnetization = sweep.magnetization;
+
+    header.variable = sweep.variable;
+    header.samplingPoints = sweep.samplingPoints;
+    header.next = sweep.next;
+    header.start = sweep.start;
+    header.step = sweep.step;
+
+    std::vector<char> buffer(fileSize(header));
+    char *cursor = buffer.data();
+    memcpy(cursor, &header, sizeof(Header));
+    cursor += sizeof(Header);
+
+    double *column[PROPERTY_COLUMNS];
+    columns(sweep.props, column);
+    for (uint c = 0; c < PROPERTY_COLUMNS && sweep.samplingPoints > 0; c++) {
+        memcpy(cursor, column[c], sizeof(double) * sweep.samplingPoints);
+        cursor += sizeof(double) * sweep.samplingPoints;
+    }
+
+    // * Un réseau compacté (codage multi-spin) est à jour dans lat.bits uniquement, qui a déjà la bonne disposition.
+    uint64_t *words = (uint64_t*)cursor;
+    if (lat.bits != nullptr) {
+        memcpy(words, lat.bits, sizeof(uint64_t) * spinWords(header));
+    }
+    else {
+        for (uint i = 0; i < lat.siteCount; i++) {
+            words[i / 64] |= (uint64_t)(lat.spin[i] > 0) << (i % 64);
+        }
+    }
+    return buffer;
+}
+
+/// @brief Ecrit le tampon dans fileName.tmp, le synchronise sur disque, puis le renomme en fileName.
+static bool writeAtomic(const std::string &fileName, const std::vector<char> &buffer) {
+    const std::string temporary = fileName + ".tmp";
+    int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "[Checkpoint] Cannot open " << temporary << "\n";
+        return false;
+    }
+
+    size_t written = 0;
+    while (written < buffer.size()) {
+        const ssize_t n = write(fd, buffer.data() + written, buffer.size() - written);
+        if (n < 0) {
+            std::cerr << "[Checkpoint] Write failed for " << temporary << "\n";
+            close(fd);
+            return false;
+        }
+        written += n;
+    }
+    if (fsync(fd) != 0 || close(fd) != 0 || rename(temporary.c_str(), fileName.c_str()) != 0) {
+        std::cerr << "[Checkpoint] Cannot commit " << fileName << "\n";
+        return false;
+    }
+
+    // * Le renommage lui-même n'est durable qu'une fois le répertoire synchronisé.
+    const size_t slash = fileName.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : fileName.substr(0, slash + 1);
+    int dir = open(directory.c_str(), O_RDONLY);
+    if (dir >= 0) {
+        fsync(dir);
+        close(dir);
+    }
+    return true;
+}
+
+bool save(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options, const Sweep &sweep) {
+    return writeAtomic(fileName, serialize(lat, options, sweep));
+}
+
+void saveAsync(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options, const Sweep &sweep) {
+    wait();
+    std::vector<char> buffer = serialize(lat, options, sweep);
+    writer = std::thread([fileName, buffer = std::move(buffer)]() {
+        writeAtomic(fileName, buffer);
+    });
+}
+
+void wait() {
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+bool saveLattice(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options) {
+    Sweep sweep = Sweep();
+    sweep.energy = Ising::latticeEnergy(lat, options.J, options.h);
+    sweep.magnetization = Ising::magnetization(lat);
+    return save(fileName, lat, options, sweep);
+}
+
+/// @brief Projette le fichier en mémoire et vérifie son en-tête. Renvoie nullptr (et ne projette rien) si invalide.
+static const char *map(const std::string &fileName, size_t &size) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    size = info.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    const bool valid = std::equal(MAGIC, MAGIC + 8, header.magic) && header.version == CHECKPOINT_VERSION && size == fileSize(header)
+        && header.iterator >= 0 && header.iterator < (int32_t)(sizeof(iterators) / sizeof(Iterator))
+        && header.equilibrator >= 0 && header.equilibrator < (int32_t)(sizeof(equilibrators) / sizeof(Equilibrator))
+        && header.dimension >= 1 && header.dimension <= Ising::MAX_DIMENSION;
+    if (!valid) {
+        std::cerr << "[Checkpoint] Invalid checkpoint " << fileName << "\n";
+        munmap(data, size);
+        return nullptr;
+    }
+    return (const char*)data;
+}
+
+/// @brief Reconstruit le réseau (spins, compactage et flux aléatoire) à partir du fichier projeté.
+static Ising::Lattice readLattice(const char *data, const Header &header) {
+    Ising::Lattice lat = header.dimension > 2 ? Ising::hypercube(header.sizeX, header.dimension) : Ising::lattice(header.sizeX, header.sizeY);
+    const uint64_t *words = (const uint64_t*)(data + fileSize(header) - sizeof(uint64_t) * spinWords(header));
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.spin[i] = (words[i / 64] >> (i % 64)) & 1 ? UP : DOWN;
+    }
+    if (header.packed) {
+        Ising::packLattice(lat);
+    }
+    std::copy(header.rng, header.rng + 4, lat.rng.s);
+    return lat;
+}
+
+bool load(const std::string &fileName, Ising::Lattice &lat, MC::Parameters &options, Sweep &sweep) {
+    size_t size;
+    const char *data = map(fileName, size);
+    if (data == nullptr) {
+        return false;
+    }
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    Ising::freeLattice(lat);
+    lat = readLattice(data, header);
+
+    options = MC::parameters(header.epochThreshold, header.jumpSize, header.dataRecordDuration, header.relativeVariation, iterators[header.iterator], header.T, header.J, header.h, header.kB);
+    options.equilibrator = equilibrators[header.equilibrator];
+    options.seed = header.seed;
+    options.threads = header.threads;
+    options.targetError = header.targetError;
+    options.iterationSteps = header.iterationSteps;
+
+    sweep = Sweep();
+    sweep.variable = (Variable)header.variable;
+    sweep.start = header.start;
+    sweep.step = header.step;
+    sweep.samplingPoints = header.samplingPoints;
+    sweep.next = header.next;
+    sweep.energy = header.energy;
+    sweep.magnetization = header.magnetization;
+
+    if (header.samplingPoints > 0) {
+        sweep.props = MC::properties(header.samplingPoints);
+        double *column[PROPERTY_COLUMNS];
+        columns(sweep.props, column);
+        const double *cursor = (const double*)(data + sizeof(Header));
+        for (uint c = 0; c < PROPERTY_COLUMNS; c++) {
+            std::copy(cursor, cursor + header.samplingPoints, column[c]);
+            cursor += header.samplingPoints;
+        }
+    }
+
+    munmap((void*)data, size);
+    return true;
+}
+
+bool loadLattice(const std::string &fileName, Ising::Lattice &lat) {
+    size_t size;
+    const char *data = map(fileName, size);
+    if (data == nullptr) {
+        return false;
+    }
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+
+    Ising::freeLattice(lat);
+    lat = readLattice(data, header);
+    munmap((void*)data, size);
+    return true;
+}
+
+/// @brief Balayage avec reprise commun aux balayages en température et en champ (voir MC::thermalizeLattice).
+static MC::Properties sweep(Ising::Lattice &lat, MC::Parameters &options, double Xi, double Xf, uint samplingPoints, const std::string &fileName, uint interval, Variable variable, const char *label) {
+    assert(samplingPoints > 1 && interval > 0);
+    double MC::Parameters::*parameter = variable == TEMPERATURE ? &MC::Parameters::T : &MC::Parameters::h;
+    double MC::Parameters::*fixed = variable == TEMPERATURE ? &MC::Parameters::h : &MC::Parameters::T;
+
+    // * Le point de reprise n'est utilisé que s'il correspond au même balayage (grille, réseau, couplage, algorithme,
+    // * paramètre fixé), sinon on repart de lat : un fichier périmé ne doit pas mélanger deux simulations.
+    const double start = std::min(Xi, Xf);
+    const double step = fabs(Xf - Xi) / (samplingPoints - 1);
+    Sweep state = Sweep();
+    Ising::Lattice restored = Ising::Lattice();
+    MC::Parameters restoredOptions = options;
+    const bool loaded = load(fileName, restored, restoredOptions, state);
+    const bool matches = loaded && state.variable == variable && state.samplingPoints == samplingPoints
+        && state.start == start && state.step == step
+        && restored.sizeX == lat.sizeX && restored.sizeY == lat.sizeY && restored.dimension == lat.dimension
+        && restoredOptions.J == options.J && restoredOptions.kB == options.kB && restoredOptions.*fixed == options.*fixed
+        && restoredOptions.mcIterator == MC::genericIterator(options.mcIterator) && restoredOptions.equilibrator == options.equilibrator;
+    if (loaded && !matches) {
+        std::cerr << "[Checkpoint] " << fileName << " does not match this sweep (grid, lattice, parameters or algorithm), starting fresh\n";
+    }
+    if (matches) {
+        std::cout << "[Checkpoint] Resuming " << fileName << " at point " << state.next << "\n";
+        Ising::freeLattice(lat);
+        lat = restored;
+        // * La série temporelle éventuelle n'est pas enregistrée : on garde celle de l'appelant.
+        restoredOptions.series = options.series;
+        restoredOptions.seriesStride = options.seriesStride;
+        // * Le fichier ne connaît que la version générique de l'itération : on garde celle, éventuellement spécialisée
+        // * (MC::specializedMetropolis), de l'appelant, qui lui correspond.
+        restoredOptions.mcIterator = options.mcIterator;
+        options = restoredOptions;
+    }
+    else {
+        Ising::freeLattice(restored);
+        if (loaded && state.samplingPoints > 0) {
+            MC::freeProperties(state.props);
+        }
+        state = Sweep();
+        state.variable = variable;
+        state.start = start;
+        state.step = step;
+        state.samplingPoints = samplingPoints;
+        state.props = MC::properties(samplingPoints);
+        options.*parameter = state.start;
+        state.energy = Ising::latticeEnergy(lat, options.J, options.h);
+        state.magnetization = Ising::magnetization(lat);
+    }
+
+    for (uint &i = state.next; i < samplingPoints;)
+    {
+        std::cout << label << " " << options.*parameter << "\n";
+        state.props.T[i] = options.*parameter;
+        MC::samplePoint(lat, options, state.props, i, state.energy, state.magnetization);
+
+        options.*parameter += state.step;
+        if (variable == FIELD) {
+            state.energy -= state.step * state.magnetization; // L'énergie totale est modifié en changeant le champ magnétique
+        }
+
+        i++;
+        if (i % interval == 0 || i == samplingPoints) {
+            saveAsync(fileName, lat, options, state);
+        }
+    }
+
+    wait();
+    return state.props;
+}
+
+MC::Properties thermalizeLattice(Ising::Lattice &lat, MC::Parameters &options, double Ti, double Tf, uint samplingPoints, const std::string &fileName, uint interval) {
+    return sweep(lat, options, Ti, Tf, samplingPoints, fileName, interval, TEMPERATURE, "[Thermalize] T =");
+}
+
+MC::Properties magnetizeLattice(Ising::Lattice &lat, MC::Parameters &options, double hi, double hf, uint samplingPoints, const std::string &fileName, uint interval) {
+    return sweep(lat, options, hi, hf, samplingPoints, fileName, interval, FIELD, "[Magnetize] h =");
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+#include <string>
+
+// Points de reprise binaires : un fichier contient le réseau (un bit par spin), l'état du flux aléatoire, les paramètres
+// de simulation, l'énergie et la magnétisation courantes, et l'état d'un balayage en T ou en h (propriétés déjà
+// accumulées et indice du prochain point). Le format est binaire natif : un fichier se relit sur la même architecture.
+// L'écriture passe par un fichier temporaire synchronisé sur disque puis renommé : un fichier de reprise est toujours
+// complet, même si le programme est interrompu pendant l'écriture.
+
+namespace Checkpoint {
+
+/// @brief Paramètre balayé.
+enum Variable {
+    TEMPERATURE = 0,
+    FIELD = 1
+};
+
+/// @brief Etat d'un balayage en cours. samplingPoints = 0 pour un simple réseau (démarrage à chaud d'une autre simulation).
+struct Sweep {
+    Variable variable;
+    double start;
+    double step;
+    uint samplingPoints;
+    uint next;
+
+    double energy;
+    double magnetization;
+
+    MC::Properties props;
+};
+
+/// @brief Ecrit un point de reprise de façon atomique (fichier temporaire, fsync puis rename), de façon synchrone.
+/// @param fileName Chemin du fichier
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation (options.mcIterator et options.equilibrator doivent être des fonctions du module MC)
+/// @param sweep Etat du balayage
+/// @return false si l'écriture a échoué (message sur std::cerr)
+bool save(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options, const Sweep &sweep);
+
+/// @brief Comme save, mais seule la copie de l'état est faite par l'appelant : l'écriture a lieu sur un thread d'arrière-plan.
+/// Attend la fin de l'écriture précédente éventuelle du même thread : il y a au plus une écriture en cours par thread.
+void saveAsync(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options, const Sweep &sweep);
+
+/// @brief Attend la fin de l'écriture en arrière-plan éventuelle lancée par le thread appelant.
+void wait();
+
+/// @brief Relit un point de reprise par projection en mémoire (mmap).
+/// En cas de succès, lat est libéré puis remplacé par le réseau relu (avec son flux aléatoire), options et sweep sont
+/// remplacés (sweep.props est alloué si samplingPoints > 0). En cas d'échec, rien n'est modifié.
+/// @param fileName Chemin du fichier
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param sweep Etat du balayage
+/// @return false si le fichier est absent, tronqué ou incompatible
+bool load(const std::string &fileName, Ising::Lattice &lat, MC::Parameters &options, Sweep &sweep);
+
+/// @brief Enregistre un réseau seul (déjà équilibré par exemple), réutilisable comme départ d'autres simulations.
+bool saveLattice(const std::string &fileName, Ising::Lattice &lat, const MC::Parameters &options);
+
+/// @brief Relit le réseau d'un point de reprise pour démarrer une nouvelle simulation sans repartir d'un état aléatoire.
+/// Les paramètres enregistrés sont ignorés ; le flux aléatoire est celui du fichier (Ising::seed pour le changer).
+/// @param fileName Chemin du fichier
+/// @param lat Réseau de spin, remplacé en cas de succès
+/// @return false si le fichier est illisible
+bool loadLattice(const std::string &fileName, Ising::Lattice &lat);
+
+/// @brief Version de MC::thermalizeLattice avec reprise : si fileName contient le même balayage en T (mêmes bornes et
+/// nombre de points, réseau de mêmes dimensions, mêmes J, kB et h, même itération et même détecteur d'équilibre),
+/// le réseau, les paramètres et les propriétés sont relus et le balayage reprend au point suivant, avec l'itération de
+/// l'appelant (une itération spécialisée est conservée). Sinon un message est affiché et le balayage part de lat.
+/// Un point de reprise est écrit en arrière-plan tous les interval points, et à la fin.
+/// @param lat Réseau de spin (remplacé en cas de reprise)
+/// @param options Paramètres de simulation (remplacés en cas de reprise)
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param samplingPoints Nombre de points à calculer
+/// @param fileName Fichier de reprise
+/// @param interval Nombre de points entre deux écritures
+MC::Properties thermalizeLattice(Ising::Lattice &lat, MC::Parameters &options, double Ti, double Tf, uint samplingPoints, const std::string &fileName, uint interval);
+
+/// @brief Version de MC::magnetizeLattice avec reprise, voir Checkpoint::thermalizeLattice (T fixée au lieu de h).
+MC::Properties magnetizeLattice(Ising::Lattice &lat, MC::Parameters &options, double hi, double hf, uint samplingPoints, const std::string &fileName, uint interval);
+}
@@ -0,0 +1,137 @@
+#include "distributed.hpp"
+
+#ifdef ISING_MPI
+
+#include "checkerboard.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace Distributed {
+
+Context &context() {
+    static Context current = Context();
+    return current;
+}
+
+Ising::Lattice slab(uint sizeX, uint sizeY, uint64_t seed) {
+    Context &ctx = context();
+    ctx.comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(ctx.comm, &ctx.rank);
+    MPI_Comm_size(ctx.comm, &ctx.size);
+    assert(sizeX % 2 == 0 && sizeY % 2 == 0 && sizeY >= (uint)ctx.size);
+
+    ctx.up = (ctx.rank + ctx.size - 1) % ctx.size;
+    ctx.down = (ctx.rank + 1) % ctx.size;
+    ctx.sizeX = sizeX;
+    ctx.sizeY = sizeY;
+    ctx.firstRow = (uint64_t)ctx.rank * sizeY / ctx.size;
+    ctx.rows = (uint64_t)(ctx.rank + 1) * sizeY / ctx.size - ctx.firstRow;
+
+    Ising::Lattice lat = Ising::lattice(sizeX, ctx.rows + 2);
+    Ising::seed(lat, seed, ctx.rank);
+    return lat;
+}
+
+void exchangeHalo(Ising::Lattice &slab) {
+    Context &ctx = context();
+    int8_t *firstRow = slab.spin + ctx.sizeX;
+    int8_t *lastRow = slab.spin + ctx.rows * ctx.sizeX;
+    int8_t *topGhost = slab.spin;
+    int8_t *bottomGhost = slab.spin + (ctx.rows + 1) * ctx.sizeX;
+
+    // * Première ligne vers le rang du haut, dernière ligne vers le rang du bas.
+    MPI_Sendrecv(firstRow, ctx.sizeX, MPI_INT8_T, ctx.up, 0, bottomGhost, ctx.sizeX, MPI_INT8_T, ctx.down, 0, ctx.comm, MPI_STATUS_IGNORE);
+    MPI_Sendrecv(lastRow, ctx.sizeX, MPI_INT8_T, ctx.down, 1, topGhost, ctx.sizeX, MPI_INT8_T, ctx.up, 1, ctx.comm, MPI_STATUS_IGNORE);
+}
+
+double latticeEnergy(Ising::Lattice &slab, double J, double h) {
+    Context &ctx = context();
+    exchangeHalo(slab);
+
+    // * Liaisons vers la droite et vers le bas de chaque ligne locale, la ligne fantôme du bas complétant la dernière.
+    int64_t local[2] = { 0, 0 };
+    for (uint y = 1; y <= ctx.rows; y++) {
+        const int8_t *row = slab.spin + y * ctx.sizeX;
+        const int8_t *below = row + ctx.sizeX;
+        for (uint x = 0; x < ctx.sizeX; x++) {
+            local[0] += row[x] * (row[(x + 1) % ctx.sizeX] + below[x]);
+            local[1] += row[x];
+        }
+    }
+
+    int64_t global[2];
+    MPI_Allreduce(local, global, 2, MPI_INT64_T, MPI_SUM, ctx.comm);
+    return - J * global[0] - h * global[1];
+}
+
+double magnetization(Ising::Lattice &slab) {
+    Context &ctx = context();
+    int64_t local = 0;
+    for (uint i = ctx.sizeX; i < (ctx.rows + 1) * ctx.sizeX; i++) {
+        local += slab.spin[i];
+    }
+
+    int64_t global;
+    MPI_Allreduce(&local, &global, 1, MPI_INT64_T, MPI_SUM, ctx.comm);
+    return global;
+}
+
+void mpiIteration(Ising::Lattice &slab, MC::Parameters &options, double &deltaE, double &deltaM) {
+    Context &ctx = context();
+    MC::updateAcceptance(options);
+
+    std::vector<int8_t> buffer(ctx.sizeX);
+    std::vector<double> random(ctx.sizeX / 2);
+    double local[2] = { 0, 0 };
+
+    for (uint color = 0; color < 2; color++) {
+        for (uint y = 1; y <= ctx.rows; y++) {
+            int8_t *row = slab.spin + y * ctx.sizeX;
+            // * La couleur d'un site dépend de son ordonnée globale.
+            const uint parity = (ctx.firstRow + y - 1 + color) & 1;
+            MC::checkerboardRow(row, row - ctx.sizeX, row + ctx.sizeX, ctx.sizeX, parity, options.table, slab.rng, buffer.data(), random.data(), local[0], local[1]);
+        }
+        exchangeHalo(slab);
+    }
+
+    double global[2];
+    MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_SUM, ctx.comm);
+    deltaE = global[0];
+    deltaM = global[1];
+}
+
+/// @brief Balayage distribué commun aux balayages en température et en champ (voir MC::thermalizeLattice).
+static MC::Properties sweep(Ising::Lattice &slab, MC::Parameters &options, double Xi, double Xf, uint samplingPoints, double MC::Parameters::*variable, const char *label) {
+    assert(samplingPoints > 1);
+
+    MC::Properties props = MC::properties(samplingPoints);
+    options.*variable = std::min(Xi, Xf);
+    const double step = fabs(Xf - Xi) / (samplingPoints - 1);
+
+    for (uint i = 0; i < samplingPoints; i++)
+    {
+        double energy = Distributed::latticeEnergy(slab, options.J, options.h);
+        double magnetization = Distributed::magnetization(slab);
+
+        if (context().rank == 0) {
+            std::cout << label << " " << options.*variable << "\n";
+        }
+        props.T[i] = options.*variable;
+        MC::samplePoint(slab, options, props, i, energy, magnetization);
+
+        options.*variable += step;
+    }
+    return props;
+}
+
+MC::Properties thermalizeLattice(Ising::Lattice &slab, MC::Parameters &options, double Ti, double Tf, uint samplingPoints) {
+    return sweep(slab, options, Ti, Tf, samplingPoints, &MC::Parameters::T, "[Thermalize] T =");
+}
+
+MC::Properties magnetizeLattice(Ising::Lattice &slab, MC::Parameters &options, double hi, double hf, uint samplingPoints) {
+    return sweep(slab, options, hi, hf, samplingPoints, &MC::Parameters::h, "[Magnetize] h =");
+}
+}
+
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+// Décomposition de domaine multi-processus (MPI) : un réseau est découpé en bandes de lignes, une par rang.
+// Chaque rang stocke ses lignes entourées de deux lignes fantômes (copies des lignes de bord des rangs voisins),
+// échangées après chaque demi-balayage en damier. Les frontières périodiques selon y (pcy) deviennent les frontières
+// entre rangs : le rang 0 a pour voisin du haut le dernier rang.
+// Compilé uniquement avec -DISING_MPI (cible make mpi).
+
+#ifdef ISING_MPI
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+#include <mpi.h>
+
+namespace Distributed {
+
+/// @brief Découpage du réseau global entre les rangs.
+// ! Un seul réseau distribué par processus : mpiIteration n'a accès qu'au réseau local.
+struct Context {
+    MPI_Comm comm;
+    int rank;
+    int size;
+    int up;
+    int down;
+    uint sizeX;
+    uint sizeY;
+    uint firstRow;
+    uint rows;
+};
+
+/// @brief Contexte du réseau distribué courant.
+Context &context();
+
+/// @brief Alloue la bande locale d'un réseau global sizeX x sizeY : sizeX x (lignes locales + 2), les lignes 0
+/// et rows + 1 étant les lignes fantômes. Le flux aléatoire local est initialisé par (seed, rang).
+/// @param sizeX Taille globale selon X (paire)
+/// @param sizeY Taille globale selon Y (paire, au moins une ligne par rang)
+/// @param seed Graine de la simulation
+/// @return Bande locale
+Ising::Lattice slab(uint sizeX, uint sizeY, uint64_t seed);
+
+/// @brief Echange les lignes de bord avec les rangs voisins pour remettre à jour les lignes fantômes.
+/// @param slab Bande locale
+void exchangeHalo(Ising::Lattice &slab);
+
+/// @brief Energie du réseau global (échange des lignes fantômes puis réduction sur tous les rangs).
+double latticeEnergy(Ising::Lattice &slab, double J, double h);
+
+/// @brief Magnétisation du réseau global (réduction sur tous les rangs).
+double magnetization(Ising::Lattice &slab);
+
+/// @brief Balayage en damier distribué : chaque demi-balayage est suivi d'un échange des lignes fantômes, et les
+/// variations d'énergie et de magnétisation sont réduites sur tous les rangs. Tous les rangs voient donc la même
+/// énergie, et reachEquilibrium prend la même décision partout.
+/// @param slab Bande locale
+/// @param options Paramètres de simulation
+/// @param deltaE Variation d'énergie globale du balayage
+/// @param deltaM Variation de magnétisation globale du balayage
+void mpiIteration(Ising::Lattice &slab, MC::Parameters &options, double &deltaE, double &deltaM);
+
+/// @brief Equivalent distribué de MC::thermalizeLattice (messages affichés par le rang 0 uniquement).
+MC::Properties thermalizeLattice(Ising::Lattice &slab, MC::Parameters &options, double Ti, double Tf, uint samplingPoints);
+
+/// @brief Equivalent distribué de MC::magnetizeLattice (messages affichés par le rang 0 uniquement).
+MC::Properties magnetizeLattice(Ising::Lattice &slab, MC::Parameters &options, double hi, double hf, uint samplingPoints);
+}
+
+#endif
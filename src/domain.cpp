@@ -0,0 +1,99 @@
+#include "domain.hpp"
+#include "checkerboard.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace MC {
+
+/// @brief Equipe de threads du thread appelant, recréée si le nombre de threads change. Une équipe par thread appelant :
+/// deux simulations concurrentes ne se sérialisent pas sur la même équipe et ne la détruisent pas en cours d'usage.
+/// domainPlace et domainIteration appelés depuis le même thread partagent l'équipe, donc le placement des bandes.
+static Parallel::Team &domainTeam(uint threads) {
+    thread_local std::unique_ptr<Parallel::Team> team;
+    if (!team || team->size() != threads) {
+        team.reset(new Parallel::Team(threads));
+    }
+    return *team;
+}
+
+/// @brief Sommes partielles d'une bande, alignées sur une ligne de cache pour éviter le faux partage.
+struct alignas(64) TileSums {
+    double deltaE;
+    double deltaM;
+};
+
+void domainPlace(Ising::Lattice &lat, uint threads) {
+    threads = std::max(1u, std::min(threads, lat.sizeY));
+    int8_t *placed = (int8_t*)malloc(sizeof(int8_t) * (lat.siteCount + 1));
+    const int8_t *old = lat.spin;
+
+    domainTeam(threads).run([&](uint tile) {
+        const uint first = tileRow(lat.sizeY, threads, tile) * lat.sizeX;
+        const uint last = tileRow(lat.sizeY, threads, tile + 1) * lat.sizeX;
+        std::memcpy(placed + first, old + first, last - first);
+    });
+
+    placed[lat.siteCount] = 0;
+    free(lat.spin);
+    lat.spin = placed;
+}
+
+void domainIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(lat.sizeY > 1 && lat.sizeX % 2 == 0 && lat.sizeY % 2 == 0);
+    updateAcceptance(options);
+
+    const uint tiles = std::max(1u, std::min(options.threads, lat.sizeY));
+    const uint sizeX = lat.sizeX;
+    const uint sizeY = lat.sizeY;
+    const uint64_t tileSeed = RNG::next(lat.rng);
+
+    Parallel::Barrier barrier(tiles);
+    std::vector<TileSums> sums(tiles);
+
+    domainTeam(tiles).run([&](uint tile) {
+        RNG::Generator rng = RNG::generator(tileSeed, tile);
+        std::vector<int8_t> buffer(sizeX);
+        std::vector<int8_t> haloAbove(sizeX);
+        std::vector<int8_t> haloBelow(sizeX);
+        std::vector<double> random(sizeX / 2);
+        double tileE = 0;
+        double tileM = 0;
+
+        const uint first = tileRow(sizeY, tiles, tile);
+        const uint last = tileRow(sizeY, tiles, tile + 1);
+
+        // * Les chargements vectoriels lisent des lignes entières, y compris les sites en cours de mise à jour : les deux
+        // * lignes des bandes voisines sont donc copiées avant que la phase ne commence, puis lues dans la copie.
+        // * Seuls leurs sites de l'autre couleur servent, et ils ne changent pas pendant la phase.
+        const int8_t *haloRowAbove = lat.spin + ((first + sizeY - 1) % sizeY) * sizeX;
+        const int8_t *haloRowBelow = lat.spin + (last % sizeY) * sizeX;
+        for (uint color = 0; color < 2; color++) {
+            std::memcpy(haloAbove.data(), haloRowAbove, sizeX);
+            std::memcpy(haloBelow.data(), haloRowBelow, sizeX);
+            barrier.wait();
+
+            for (uint y = first; y < last; y++) {
+                int8_t *row = lat.spin + y * sizeX;
+                const int8_t *above = y == first ? haloAbove.data() : row - sizeX;
+                const int8_t *below = y + 1 == last ? haloBelow.data() : row + sizeX;
+                checkerboardRow(row, above, below, sizeX, (y + color) & 1, options.table, rng, buffer.data(), random.data(), tileE, tileM);
+            }
+            barrier.wait();
+        }
+
+        sums[tile].deltaE = tileE;
+        sums[tile].deltaM = tileM;
+    });
+
+    deltaE = 0;
+    deltaM = 0;
+    for (const TileSums &partial : sums) {
+        deltaE += partial.deltaE;
+        deltaM += partial.deltaM;
+    }
+}
+}
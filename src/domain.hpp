@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Décomposition de domaine d'un seul réseau sur tous les coeurs d'un noeud : le réseau est découpé en bandes de
+// lignes, une par thread d'une équipe persistante. Chaque balayage en damier se fait en deux phases (une par couleur)
+// séparées par une barrière ; chaque bande a son propre flux aléatoire et ses propres sommes partielles.
+
+namespace MC {
+
+/// @brief Première ligne de la bande d'un thread (la bande tile s'étend de tileRow(tile) à tileRow(tile + 1)).
+/// @param sizeY Nombre de lignes du réseau
+/// @param tiles Nombre de bandes
+/// @param tile Numéro de la bande
+/// @return Indice de la première ligne
+inline uint tileRow(const uint sizeY, const uint tiles, const uint tile) {
+    return (uint64_t)tile * sizeY / tiles;
+}
+
+/// @brief Réalloue le tableau de spins pour que chaque bande soit touchée en premier par le thread qui la met à jour :
+/// avec la politique « first touch » du noyau, les pages de chaque bande sont placées sur le noeud NUMA de son thread.
+/// A appeler une fois avant la simulation, depuis le thread qui appellera domainIteration et avec le même nombre de
+/// threads que options.threads : les bandes sont alors touchées par les mêmes workers.
+/// @param lat Réseau de spin
+/// @param threads Nombre de threads
+void domainPlace(Ising::Lattice &lat, uint threads);
+
+/// @brief Effectue un balayage complet en damier réparti sur options.threads threads (une bande de lignes chacun).
+/// Les variations d'énergie et de magnétisation partielles des bandes sont réduites dans deltaE et deltaM.
+/// Réseau 2D de tailles paires, comme checkerboardIteration.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void domainIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
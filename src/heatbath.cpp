@@ -0,0 +1,61 @@
+#include "heatbath.hpp"
+
+#include <vector>
+
+namespace MC {
+
+/// @brief Champ local d'un site, par la table de voisinage si le réseau en a une, par les pas sinon.
+static inline int field(const Ising::Lattice &lat, const uint site) {
+    return lat.neighbor != nullptr ? Ising::localField(lat, site) : Ising::hypercubeField(lat, site);
+}
+
+void heatBathIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    updateAcceptance(options);
+    const uint site = RNG::bounded(lat.rng, lat.siteCount);
+
+    const int spin = lat.spin[site];
+    const int k = tableIndex(field(lat, site), spin);
+
+    TELEMETRY_ADD(attempts, 1);
+    if (RNG::uniform(lat.rng) < options.table.heatBath[k]) {
+        lat.spin[site] = -spin;
+        deltaE = options.table.deltaE[k];
+        deltaM = - 2 * spin;
+        TELEMETRY_ADD(accepted, 1);
+    }
+    else {
+        deltaE = 0;
+        deltaM = 0;
+    }
+}
+
+void heatBathSweepIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    updateAcceptance(options);
+    const AcceptanceTable &table = options.table;
+
+    // * Tirages par ligne : le parcours séquentiel interdit de calculer les champs à l'avance, pas les nombres aléatoires.
+    std::vector<double> random(lat.sizeX);
+    uint flips = 0;
+    double sweepE = 0;
+    int64_t sweepM = 0;
+
+    for (uint row = 0; row < lat.siteCount; row += lat.sizeX) {
+        RNG::uniform(lat.rng, random.data(), lat.sizeX);
+        for (uint x = 0; x < lat.sizeX; x++) {
+            const uint site = row + x;
+            const int spin = lat.spin[site];
+            const int k = tableIndex(field(lat, site), spin);
+            const int flip = random[x] < table.heatBath[k];
+            flips += flip;
+            sweepE += flip * table.deltaE[k];
+            sweepM -= flip * 2 * spin;
+            lat.spin[site] = spin * (1 - 2 * flip);
+        }
+    }
+
+    TELEMETRY_ADD(attempts, lat.siteCount);
+    TELEMETRY_ADD(accepted, flips);
+    deltaE = sweepE;
+    deltaM = sweepM;
+}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Dynamique du bain thermique (Glauber) : le spin d'un site prend la valeur UP avec la probabilité d'équilibre
+// conditionnée à ses voisins, ce qui revient à le retourner avec la probabilité 1 / (1 + exp(ΔE/kT)).
+// Les probabilités sont lues dans la table d'acceptation (AcceptanceTable::heatBath), reconstruite par updateAcceptance
+// dès que T, J, h ou kB changent : aucun exp dans la boucle. Fonctionne sur les réseaux 1D, 2D et hypercubiques.
+
+namespace MC {
+
+/// @brief Met à jour un site aléatoire par bain thermique (même coût et même unité d'itération que metropolisIteration).
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie
+/// @param deltaM Variable où stocker la différence de magnetisation
+void heatBathIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+
+/// @brief Met à jour tous les sites dans l'ordre du stockage par bain thermique (sizeXY mises à jour).
+/// Une itération correspond donc à un balayage, comme checkerboardIteration.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void heatBathSweepIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
@@ -0,0 +1,205 @@
+#include "hypercube.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace MC {
+
+/// @brief Champ local d'un site en dimension D, boucle sur les voisins déroulée à la compilation.
+template <uint D>
+static inline int field(const Ising::Lattice &lat, const uint site) {
+    int sum = 0;
+    for (uint k = 0; k < 2 * D; k++) {
+        sum += lat.spin[Ising::hypercubeNeighbor(lat, site, k)];
+    }
+    return sum;
+}
+
+template <uint D>
+static void metropolis(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    const uint site = RNG::bounded(lat.rng, lat.siteCount);
+    const int spin = lat.spin[site];
+    const int k = tableIndex(field<D>(lat, site), spin);
+    deltaE = options.table.deltaE[k];
+    deltaM = - 2 * spin;
+
+    TELEMETRY_ADD(attempts, 1);
+    if (deltaE <= 0 || RNG::uniform(lat.rng) < options.table.probability[k]) {
+        lat.spin[site] = -spin;
+        TELEMETRY_ADD(accepted, 1);
+    }
+    else {
+        deltaE = 0;
+        deltaM = 0;
+    }
+}
+
+void hypercubeMetropolisIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    updateAcceptance(options);
+    switch (lat.dimension) {
+        case 1: metropolis<1>(lat, options, deltaE, deltaM); break;
+        case 2: metropolis<2>(lat, options, deltaE, deltaM); break;
+        case 3: metropolis<3>(lat, options, deltaE, deltaM); break;
+        default: metropolis<4>(lat, options, deltaE, deltaM); break;
+    }
+}
+
+template <uint D>
+static void wolff(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    const double bondProbability = options.table.bondProbability;
+    int8_t *spin = lat.spin;
+    uint *stack = lat.stack;
+    uint *stamp = lat.stamp;
+    uint *cluster = lat.label;
+
+    // * Nouvelle époque : un site appartient au cluster courant ssi stamp == epoch.
+    if (++lat.epoch == 0) {
+        std::fill(stamp, stamp + lat.siteCount, 0);
+        lat.epoch = 1;
+    }
+    const uint epoch = lat.epoch;
+
+    const uint seed = RNG::bounded(lat.rng, lat.siteCount);
+    const int spin0 = spin[seed];
+
+    uint top = 0;
+    stack[top++] = seed;
+    stamp[seed] = epoch;
+
+    uint clusterSize = 0;
+    int64_t clusterField = 0;
+
+    while (top > 0) {
+        const uint site = stack[--top];
+
+        int sum = 0;
+        for (uint k = 0; k < 2 * D; k++) {
+            const uint next = Ising::hypercubeNeighbor(lat, site, k);
+            sum += spin[next];
+            if (spin[next] == spin0 && stamp[next] != epoch && RNG::uniform(lat.rng) < bondProbability) {
+                stamp[next] = epoch;
+                stack[top++] = next;
+            }
+        }
+
+        clusterField += sum;
+        spin[site] = -spin0;
+        cluster[clusterSize++] = site;
+    }
+
+    TELEMETRY_CLUSTER(clusterSize);
+    TELEMETRY_ADD(attempts, clusterSize);
+    lat.clusterSize = clusterSize;
+
+    if (!acceptCluster(lat, options, spin0, cluster, clusterSize)) {
+        deltaE = 0;
+        deltaM = 0;
+        return;
+    }
+
+    // * Même règle de rejet des clusters quasi complets que wolffIteration.
+    if (clusterSize > 0.8 * lat.sizeXY) {
+        for (uint j = 0; j < clusterSize; j++) {
+            spin[cluster[j]] = spin0;
+        }
+        deltaE = 0;
+        deltaM = 0;
+        return;
+    }
+
+    TELEMETRY_ADD(accepted, clusterSize);
+    deltaE = 2 * options.J * spin0 * clusterField + 2 * options.h * spin0 * (double)clusterSize;
+    deltaM = - 2 * (double)clusterSize * spin0;
+}
+
+void hypercubeWolffIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    updateAcceptance(options);
+    Ising::allocateWorkspace(lat);
+    switch (lat.dimension) {
+        case 1: wolff<1>(lat, options, deltaE, deltaM); break;
+        case 2: wolff<2>(lat, options, deltaE, deltaM); break;
+        case 3: wolff<3>(lat, options, deltaE, deltaM); break;
+        default: wolff<4>(lat, options, deltaE, deltaM); break;
+    }
+}
+
+/// @brief Met à jour les sites d'une couleur d'une ligne selon x, de premier site base.
+template <uint D>
+static void checkerboardLine(Ising::Lattice &lat, const uint base, const uint color, const AcceptanceTable &table, int8_t *__restrict buffer, double *random, double &deltaE, double &deltaM) {
+    const uint L = lat.sizeX;
+    int8_t *row = lat.spin + base;
+
+    // * Les lignes voisines selon les autres coordonnées : le repliement est le même pour toute la ligne.
+    const int8_t *lines[2 * D];
+    for (uint k = 2; k < 2 * D; k++) {
+        lines[k] = lat.spin + Ising::hypercubeNeighbor(lat, base, k);
+    }
+
+    // * Parité de la somme des coordonnées autres que x, le côté étant pair.
+    uint parity = color;
+    for (uint d = 1; d < D; d++) {
+        parity += base / lat.stride[d];
+    }
+    parity &= 1;
+
+    // * Champs de toute la ligne (ils ne dépendent que de l'autre couleur), boucle sans repliement vectorisable.
+    for (uint x = 1; x + 1 < L; x++) {
+        int sum = row[x - 1] + row[x + 1];
+        for (uint k = 2; k < 2 * D; k++) {
+            sum += lines[k][x];
+        }
+        buffer[x] = tableIndex(sum, row[x]);
+    }
+    for (uint x = 0; x < L; x += L - 1) {
+        int sum = row[(x + L - 1) % L] + row[(x + 1) % L];
+        for (uint k = 2; k < 2 * D; k++) {
+            sum += lines[k][x];
+        }
+        buffer[x] = tableIndex(sum, row[x]);
+    }
+
+    RNG::uniform(lat.rng, random, L / 2);
+
+    // * Sommes locales : deltaE et deltaM, passés par référence, resteraient en mémoire dans la boucle.
+    uint flips = 0;
+    double lineE = 0;
+    int lineM = 0;
+    for (uint j = 0, x = parity; x < L; j++, x += 2) {
+        const int k = buffer[x];
+        const int flip = random[j] < table.probability[k];
+        flips += flip;
+        lineE += flip * table.deltaE[k];
+        lineM -= flip * 2 * row[x];
+        row[x] *= 1 - 2 * flip;
+    }
+    deltaE += lineE;
+    deltaM += lineM;
+    TELEMETRY_ADD(attempts, L / 2);
+    TELEMETRY_ADD(accepted, flips);
+}
+
+template <uint D>
+static void checkerboard(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    std::vector<int8_t> buffer(lat.sizeX);
+    std::vector<double> random(lat.sizeX / 2);
+
+    for (uint color = 0; color < 2; color++) {
+        for (uint base = 0; base < lat.siteCount; base += lat.sizeX) {
+            checkerboardLine<D>(lat, base, color, options.table, buffer.data(), random.data(), deltaE, deltaM);
+        }
+    }
+}
+
+void hypercubeCheckerboardIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(lat.dimension > 1 && lat.sizeX % 2 == 0 && lat.sizeY % 2 == 0);
+    updateAcceptance(options);
+
+    deltaE = 0;
+    deltaM = 0;
+    switch (lat.dimension) {
+        case 2: checkerboard<2>(lat, options, deltaE, deltaM); break;
+        case 3: checkerboard<3>(lat, options, deltaE, deltaM); break;
+        default: checkerboard<4>(lat, options, deltaE, deltaM); break;
+    }
+}
+}
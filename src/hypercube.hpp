@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Itérations pour les réseaux hypercubiques de dimension 1 à 4 (Ising::hypercube). Les voisins sont obtenus par les
+// pas du réseau (Ising::hypercubeNeighbor) et non par une table : un réseau 4D coûte 2 octets par site au lieu de 33.
+// Chaque itération choisit une fois par appel une instanciation déroulée pour la dimension du réseau.
+// Elles s'appliquent aussi aux réseaux 1D et 2D construits par Ising::lattice.
+
+namespace MC {
+
+/// @brief Effectue une tentative de spin-flip de Metropolis sur un site aléatoire d'un réseau hypercubique.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie
+/// @param deltaM Variable où stocker la différence de magnetisation
+void hypercubeMetropolisIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+
+/// @brief Construit et retourne un cluster de Wolff sur un réseau hypercubique, mêmes règles que wolffIteration
+/// (y compris l'acceptation du cluster pour h != 0).
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie
+/// @param deltaM Variable où stocker la différence de magnetisation
+void hypercubeWolffIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+
+/// @brief Effectue un balayage complet en damier (somme des coordonnées paire, puis impaire) sur un réseau hypercubique
+/// de côté pair. Le réseau est parcouru par lignes selon x : les champs d'une ligne sont sommés depuis les 2(D - 1)
+/// lignes voisines par une boucle vectorisée, puis les sites de la couleur courante sont acceptés sans branchement.
+/// Une itération correspond à un balayage, comme checkerboardIteration.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void hypercubeCheckerboardIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
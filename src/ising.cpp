@@ -1,19 +1,32 @@
 #include "ising.hpp"
 
+#include <algorithm>
+
 namespace Ising {
 
-int zero = 0;
+/// @brief Renseigne les pas du réseau pour les côtés donnés et marque les sites de bord dans wrap.
+static void buildGeometry(Lattice &lat, const uint *sizes, const uint dimension) {
+    lat.dimension = dimension;
+    lat.stride[0] = 1;
+    for (uint d = 0; d < MAX_DIMENSION; d++) {
+        lat.stride[d + 1] = lat.stride[d] * (d < dimension ? sizes[d] : 1);
+    }
 
-Lattice lattice(const uint sizeX, const uint sizeY) {
-    Lattice lat = Lattice();
-    lat.spin = (int**)malloc(sizeof(int*) * sizeY);
-        
-    for (uint i = 0; i < sizeY; i++) {
-        lat.spin[i] = (int*)malloc(sizeof(int) * sizeX);
+    lat.wrap = (uint8_t*)calloc(lat.siteCount, sizeof(uint8_t));
+    for (uint i = 0; i < lat.siteCount; i++) {
+        for (uint d = 0; d < dimension; d++) {
+            const uint coordinate = (i / lat.stride[d]) % sizes[d];
+            lat.wrap[i] |= (coordinate == sizes[d] - 1) << (2 * d);
+            lat.wrap[i] |= (coordinate == 0) << (2 * d + 1);
+        }
     }
+}
 
+Lattice lattice(const uint sizeX, const uint sizeY) {
+    Lattice lat = Lattice();
     lat.sizeX = sizeX;
     lat.sizeY = sizeY;
+    lat.siteCount = sizeX * sizeY;
     lat.sizeXY = sizeX * sizeY;
     lat.neighborCount = 2;
 
@@ -21,6 +34,30 @@ Lattice lattice(const uint sizeX, const uint sizeY) {
         lat.neighborCount = 1;
     }
 
+    // * Un site fantôme supplémentaire, toujours nul, sert de voisin selon y dans le cas 1D.
+    lat.spin = (int8_t*)calloc(lat.siteCount + 1, sizeof(int8_t));
+    lat.neighbor = (uint*)malloc(sizeof(uint) * NEIGHBORS * lat.siteCount);
+    lat.rng = RNG::generator(0, 0);
+
+    for (uint y = 0; y < sizeY; y++) {
+        for (uint x = 0; x < sizeX; x++) {
+            uint *n = lat.neighbor + NEIGHBORS * (y * sizeX + x);
+            n[XPLUS] = siteIndex(lat, x + 1, y);
+            n[XMINUS] = siteIndex(lat, x - 1, y);
+            n[YPLUS] = siteIndex(lat, x, y + 1);
+            n[YMINUS] = siteIndex(lat, x, y - 1);
+
+            // * Dans le cas 1D, cela évite le comptage de la case (x,y) elle-même à cause de pcy().
+            if (sizeY == 1) {
+                n[YPLUS] = lat.siteCount;
+                n[YMINUS] = lat.siteCount;
+            }
+        }
+    }
+
+    const uint sizes[2] = { sizeX, sizeY };
+    buildGeometry(lat, sizes, sizeY == 1 ? 1 : 2);
+
     return lat;
 }
 
@@ -28,12 +65,152 @@ Lattice lattice(const uint sizeX) {
     return lattice(sizeX, 1);
 }
 
-int* _getSpinRef(Lattice &lat, const int x, const int y) {
+Lattice hypercube(const uint L, const uint D) {
+    assert(D >= 1 && D <= MAX_DIMENSION);
+    if (D <= 2) {
+        return lattice(L, D == 2 ? L : 1);
+    }
+
+    Lattice lat = Lattice();
+    lat.sizeX = L;
+    lat.sizeY = 1;
+    for (uint d = 1; d < D; d++) {
+        lat.sizeY *= L;
+    }
+    lat.siteCount = lat.sizeX * lat.sizeY;
+    lat.sizeXY = lat.siteCount;
+    lat.neighborCount = D;
+
+    // * Pas de table de voisinage : 2D uint par site coûteraient 24 à 32 fois la place des spins.
+    lat.spin = (int8_t*)calloc(lat.siteCount + 1, sizeof(int8_t));
+    lat.neighbor = nullptr;
+    lat.rng = RNG::generator(0, 0);
+
+    const uint sizes[MAX_DIMENSION] = { L, L, L, L };
+    buildGeometry(lat, sizes, D);
+
+    return lat;
+}
+
+Lattice copyLattice(const Lattice &lat) {
+    Lattice copy = lat;
+    copy.spin = (int8_t*)malloc(sizeof(int8_t) * (lat.siteCount + 1));
+    copy.wrap = (uint8_t*)malloc(sizeof(uint8_t) * lat.siteCount);
+    std::copy(lat.spin, lat.spin + lat.siteCount + 1, copy.spin);
+    std::copy(lat.wrap, lat.wrap + lat.siteCount, copy.wrap);
+
+    copy.neighbor = nullptr;
+    if (lat.neighbor != nullptr) {
+        copy.neighbor = (uint*)malloc(sizeof(uint) * NEIGHBORS * lat.siteCount);
+        std::copy(lat.neighbor, lat.neighbor + NEIGHBORS * lat.siteCount, copy.neighbor);
+    }
+
+    copy.bits = nullptr;
+    if (lat.bits != nullptr) {
+        const uint words = wordsPerRow(lat) * lat.sizeY;
+        copy.bits = (uint64_t*)malloc(sizeof(uint64_t) * words);
+        std::copy(lat.bits, lat.bits + words, copy.bits);
+    }
+
+    copy.stamp = nullptr;
+    copy.stack = nullptr;
+    copy.label = nullptr;
+    copy.order = nullptr;
+    copy.position = nullptr;
+    return copy;
+}
+
+void freeLattice(Lattice &lat) {
+    free(lat.spin);
+    free(lat.neighbor);
+    free(lat.wrap);
+    free(lat.bits);
+    free(lat.stamp);
+    free(lat.stack);
+    free(lat.label);
+    free(lat.order);
+    free(lat.position);
+    lat.spin = nullptr;
+    lat.neighbor = nullptr;
+    lat.wrap = nullptr;
+    lat.bits = nullptr;
+    lat.stamp = nullptr;
+    lat.stack = nullptr;
+    lat.label = nullptr;
+    lat.order = nullptr;
+    lat.position = nullptr;
+}
+
+void allocateWorkspace(Lattice &lat) {
+    if (lat.stamp != nullptr) {
+        return;
+    }
+    lat.stamp = (uint*)calloc(lat.siteCount, sizeof(uint));
+    lat.stack = (uint*)malloc(sizeof(uint) * lat.siteCount);
+    lat.label = (uint*)malloc(sizeof(uint) * lat.siteCount);
+    lat.epoch = 0;
+}
+
+void seed(Lattice &lat, uint64_t seed, uint64_t stream) {
+    lat.rng = RNG::generator(seed, stream);
+}
+
+void packLattice(Lattice &lat) {
+    assert(lat.sizeX % 64 == 0 && lat.sizeY > 1);
+    if (lat.bits != nullptr) {
+        return;
+    }
+
+    const uint words = wordsPerRow(lat) * lat.sizeY;
+    lat.bits = (uint64_t*)calloc(words, sizeof(uint64_t));
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.bits[i / 64] |= (uint64_t)(lat.spin[i] > 0) << (i % 64);
+    }
+}
+
+void unpackLattice(Lattice &lat) {
+    if (lat.bits == nullptr) {
+        return;
+    }
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.spin[i] = (lat.bits[i / 64] >> (i % 64)) & 1 ? UP : DOWN;
+    }
+
+    free(lat.bits);
+    lat.bits = nullptr;
+}
+
+/// @brief Energie d'un réseau compacté : on compte les liaisons antiparallèles par popcount.
+static double packedEnergy(Lattice &lat, double J, double h) {
+    const uint W = wordsPerRow(lat);
+    int64_t antiparallel = 0;
+
+    for (uint y = 0; y < lat.sizeY; y++) {
+        const uint64_t *row = lat.bits + y * W;
+        const uint64_t *below = lat.bits + ((y + 1) % lat.sizeY) * W;
+        for (uint w = 0; w < W; w++) {
+            // * Voisin x + 1 de chaque bit : décalage d'un bit et report du premier bit du mot suivant.
+            const uint64_t right = (row[w] >> 1) | (row[(w + 1) % W] << 63);
+            antiparallel += __builtin_popcountll(row[w] ^ right) + __builtin_popcountll(row[w] ^ below[w]);
+        }
+    }
+
+    const int64_t bonds = 2 * (int64_t)lat.siteCount - 2 * antiparallel;
+    return - J * bonds - h * magnetization(lat);
+}
+
+uint siteIndex(Lattice &lat, const int x, const int y) {
+    return pcy(lat, y) * lat.sizeX + pcx(lat, x);
+}
+
+int8_t* _getSpinRef(Lattice &lat, const int x, const int y) {
     // * Dans le cas 1D, cela évite le comptage de la case  (x,y) elle-même à cause de pcy().
     if (lat.sizeY == 1 && y != 0) {
-        return &zero;
+        return &lat.spin[lat.siteCount];
     }
-    return &lat.spin[pcy(lat, y)][pcx(lat, x)];
+    return &lat.spin[siteIndex(lat, x, y)];
 }
 
 int getSpin(Lattice &lat, const int x, const int y) {
@@ -48,48 +225,85 @@ void flipSpin(Lattice &lat, const int x, const int y) {
     *_getSpinRef(lat, x, y) *= -1;
 }
 
+void flipSpin(Lattice &lat, const uint site) {
+    lat.spin[site] = -lat.spin[site];
+}
+
+/// @brief Libère les classes n-fold way, périmées après une initialisation globale des spins.
+static void dropClasses(Lattice &lat) {
+    free(lat.order);
+    free(lat.position);
+    lat.order = nullptr;
+    lat.position = nullptr;
+}
+
 void uniformSpin(Lattice &lat, const int spinValue) {
-    for (uint y = 0; y < lat.sizeY; y++) {
-        for (uint x = 0; x < lat.sizeX; x++) {
-            setSpin(lat, x, y, spinValue);
-        }
+    dropClasses(lat);
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.spin[i] = spinValue;
     }
 }
 
 void randomSpin(Lattice &lat, const double p) {
     assert(p >= 0);
-    int spinValue = 0;
-    
-    for (uint y = 0; y < lat.sizeY; y++) {
-        for (uint x = 0; x < lat.sizeX; x++) {
-            spinValue = (double)std::rand() / RAND_MAX < p ? UP : DOWN;
-            setSpin(lat, x, y, spinValue);
-        }
+    dropClasses(lat);
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.spin[i] = RNG::uniform(lat.rng) < p ? UP : DOWN;
     }
 }
 
 double latticeEnergy(Lattice &lat, double J, double h) {
-    int latEnergy = 0;
-    for (uint y = 0; y < lat.sizeY; y++) {
-        for (uint x = 0; x < lat.sizeX; x++) {
-            latEnergy -= J * getSpin(lat, x, y) * ( getSpin(lat, x + 1, y) + getSpin(lat, x, y + 1) );
-            latEnergy -= h * getSpin(lat, x, y);
+    if (lat.bits != nullptr) {
+        return packedEnergy(lat, J, h);
+    }
+
+    // * Les sommes sont entières : on ne multiplie par J et h qu'une seule fois à la fin.
+    int64_t bonds = 0;
+    int64_t spins = 0;
+    if (lat.neighbor == nullptr) {
+        // * Chaque liaison est comptée une fois, depuis son extrémité inférieure (voisins pairs 2d).
+        for (uint i = 0; i < lat.siteCount; i++) {
+            int forward = 0;
+            for (uint d = 0; d < lat.dimension; d++) {
+                forward += lat.spin[hypercubeNeighbor(lat, i, 2 * d)];
+            }
+            bonds += lat.spin[i] * forward;
+            spins += lat.spin[i];
         }
+        return - J * bonds - h * spins;
     }
-    return latEnergy;
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        const uint *n = lat.neighbor + NEIGHBORS * i;
+        bonds += lat.spin[i] * (lat.spin[n[XPLUS]] + lat.spin[n[YPLUS]]);
+        spins += lat.spin[i];
+    }
+    return - J * bonds - h * spins;
 }
 
 double swappingEnergy(Lattice &lat, const int x, const int y, double J, double h) {
-    const int neighbor_count = getSpin(lat, x + 1, y) + getSpin(lat, x, y + 1) + getSpin(lat, x - 1, y) + getSpin(lat, x, y - 1);
-    return 2 * J * getSpin(lat, x, y) * neighbor_count + 2 * h * getSpin(lat, x, y);
+    return swappingEnergy(lat, siteIndex(lat, x, y), J, h);
+}
+
+double swappingEnergy(Lattice &lat, const uint site, double J, double h) {
+    const int spin = lat.spin[site];
+    const int field = lat.neighbor != nullptr ? localField(lat, site) : hypercubeField(lat, site);
+    return 2 * J * spin * field + 2 * h * spin;
 }
 
 double magnetization(Lattice &lat) {
-    double mag = 0;
-    for (uint y = 0; y < lat.sizeY; y++) {
-        for (uint x = 0; x < lat.sizeY; x++) {
-            mag += getSpin(lat, x, y);
+    int64_t mag = 0;
+    if (lat.bits != nullptr) {
+        const uint words = wordsPerRow(lat) * lat.sizeY;
+        for (uint w = 0; w < words; w++) {
+            mag += __builtin_popcountll(lat.bits[w]);
         }
+        return 2 * mag - (int64_t)lat.siteCount;
+    }
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        mag += lat.spin[i];
     }
     return mag;
 }
@@ -98,6 +312,10 @@ double swappingMagnetization(Lattice &lat, const int x, const int y) {
     return - 2 * getSpin(lat, x, y);
 }
 
+double swappingMagnetization(Lattice &lat, const uint site) {
+    return - 2 * lat.spin[site];
+}
+
 int pcx(Lattice &lat, int x) {
     return (x + lat.sizeX) % lat.sizeX;
 }
@@ -106,4 +324,4 @@ int pcy(Lattice &lat, int y) {
     // * (y + lat.sizeY): petite astuce pour ne pas avoir à définir une méthode de modulo positive.
     return (y + lat.sizeY) % lat.sizeY;
 }
-}
\ No newline at end of file
+}
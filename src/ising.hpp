@@ -1,19 +1,75 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <cassert>
+#include "rng.hpp"
 
 #define UP 1
 #define DOWN -1
 
 namespace Ising {
+/// @brief Directions de la table de voisinage d'un site.
+enum Direction {
+    XPLUS = 0,
+    XMINUS = 1,
+    YPLUS = 2,
+    YMINUS = 3,
+    NEIGHBORS = 4
+};
+
+/// @brief Dimension maximale d'un réseau hypercubique et nombre de voisins correspondant.
+enum Hypercube {
+    MAX_DIMENSION = 4,
+    MAX_NEIGHBORS = 2 * MAX_DIMENSION
+};
+
 /// @brief Définit un réseau de spin de taille fixe.
+/// Les spins sont stockés de façon contiguë (site = y * sizeX + x), la périodicité est précalculée
+/// dans la table neighbor : le voisin k du site i est neighbor[NEIGHBORS * i + k].
+/// Lorsque bits est non nul, le réseau est compacté (64 spins par mot, voir packLattice) : bits fait foi
+/// et spin n'est plus à jour jusqu'à l'appel de unpackLattice.
+/// Chaque réseau possède son propre flux aléatoire rng (voir seed).
+/// Quelle que soit sa dimension, le réseau décrit aussi sa géométrie par des pas : la coordonnée d du site i varie
+/// de stride[d] en stride[d], et les bits 2d et 2d + 1 de wrap[i] indiquent que le site est sur le bord supérieur
+/// ou inférieur selon d (voir hypercubeNeighbor). Un réseau de dimension 3 ou 4 n'a pas de table neighbor.
 struct Lattice {
-    int **spin;
+    int8_t *spin;
+    uint *neighbor;
+    uint64_t *bits;
     uint sizeX;
     uint sizeY;
+    uint siteCount;
     double sizeXY;
     double neighborCount;
+
+    uint dimension;
+    uint stride[MAX_DIMENSION + 1];
+    uint8_t *wrap;
+
+    RNG::Generator rng;
+
+    // Espace de travail des algorithmes de cluster (voir allocateWorkspace)
+    uint *stamp;
+    uint *stack;
+    uint *label;
+    uint epoch;
+
+    // Σ|C|² / N du dernier balayage de Swendsen-Wang : estimateur amélioré de <M²> / N
+    double clusterMoment;
+
+    // Taille du dernier cluster de Wolff construit, qu'il ait été gardé ou rejeté
+    uint clusterSize;
+
+    // Classes de l'algorithme n-fold way (voir MC::nFoldIteration), construites au premier appel : les sites rangés
+    // par classe dans order, la classe c occupant [classStart[c], classStart[c + 1]), et la place de chaque site dans position.
+    // Une initialisation globale (uniformSpin, randomSpin) les libère, elles sont alors reconstruites.
+    uint *order;
+    uint *position;
+    uint classStart[2 * MAX_NEIGHBORS + 3];
+    // Tentatives restantes avant le prochain retournement et probabilité de retournement par tentative
+    double waiting;
+    double rate;
 };
 
 /// @brief Alloue un réseau de spin 2D de taille donné.
@@ -27,12 +83,109 @@ Lattice lattice(const uint sizeX, const uint sizeY);
 /// @return Réseau de spin alloué
 Lattice lattice(const uint sizeX);
 
+/// @brief Alloue un réseau hypercubique périodique de côté L en dimension D, stocké à plat
+/// (site = x + L y + L² z + L³ w). Pour D = 1 ou 2, équivalent à lattice(L) ou lattice(L, L).
+/// Pour D > 2, sizeX = L et sizeY = L^(D - 1) : seules les itérations hypercubiques (voir hypercube.hpp),
+/// latticeEnergy, swappingEnergy et magnetization s'appliquent.
+/// @param L Côté du réseau
+/// @param D Dimension (1 à MAX_DIMENSION)
+/// @return Réseau de spin alloué
+Lattice hypercube(const uint L, const uint D);
+
+/// @brief Copie profonde d'un réseau (spins, table de voisinage, représentation compactée).
+/// L'espace de travail n'est pas copié et le flux aléatoire doit être réinitialisé par seed.
+/// @param lat Réseau de spin à copier
+/// @return Copie indépendante du réseau
+Lattice copyLattice(const Lattice &lat);
+
+/// @brief Libère la mémoire d'un réseau de spin.
+/// @param lat Réseau de spin à libérer
+void freeLattice(Lattice &lat);
+
+/// @brief Initialise le flux aléatoire propre au réseau.
+/// @param lat Réseau de spin
+/// @param seed Graine de la simulation
+/// @param stream Numéro du flux (un par réseau, réplique ou thread)
+void seed(Lattice &lat, uint64_t seed, uint64_t stream);
+
+/// @brief Alloue, au premier appel seulement, l'espace de travail des algorithmes de cluster :
+/// un marqueur d'époque, une pile de sites et une table d'étiquettes, chacun de taille siteCount.
+/// @param lat Réseau de spin
+void allocateWorkspace(Lattice &lat);
+
+/// @brief Compacte le réseau à raison de 64 spins par mot : le bit b du mot w de la ligne y
+/// correspond au site x = 64 * w + b, un bit à 1 représente un spin UP.
+/// @param lat Réseau de spin 2D dont sizeX est un multiple de 64
+void packLattice(Lattice &lat);
+
+/// @brief Recopie le réseau compacté dans le tableau de spins et libère la représentation compactée.
+/// @param lat Réseau de spin compacté
+void unpackLattice(Lattice &lat);
+
+/// @brief Nombre de mots de 64 bits par ligne du réseau compacté.
+/// @param lat Réseau de spin
+/// @return Nombre de mots par ligne
+inline uint wordsPerRow(const Lattice &lat) {
+    return lat.sizeX / 64;
+}
+
+/// @brief Retourne l'indice du voisin k d'un site, sans modulo ni branchement.
+/// En 1D, les voisins selon y pointent vers un site fantôme de spin nul (indice siteCount).
+/// @param lat Réseau de spin
+/// @param site Indice du site
+/// @param k Direction du voisin (XPLUS, XMINUS, YPLUS, YMINUS)
+/// @return Indice du site voisin
+inline uint neighbor(const Lattice &lat, const uint site, const uint k) {
+    return lat.neighbor[NEIGHBORS * site + k];
+}
+
+/// @brief Somme des spins voisins d'un site.
+/// @param lat Réseau de spin
+/// @param site Indice du site
+/// @return Champ local (en unité de J)
+inline int localField(const Lattice &lat, const uint site) {
+    const uint *n = lat.neighbor + NEIGHBORS * site;
+    return lat.spin[n[XPLUS]] + lat.spin[n[XMINUS]] + lat.spin[n[YPLUS]] + lat.spin[n[YMINUS]];
+}
+
+/// @brief Retourne l'indice du voisin k d'un site à partir des pas du réseau, sans table de voisinage :
+/// k = 2d pour le voisin suivant selon la coordonnée d, 2d + 1 pour le précédent.
+/// @param lat Réseau de spin
+/// @param site Indice du site
+/// @param k Direction du voisin (0 à 2 * dimension - 1)
+/// @return Indice du site voisin
+inline uint hypercubeNeighbor(const Lattice &lat, const uint site, const uint k) {
+    const uint d = k >> 1;
+    // * Sur un bord, le pas stride[d] sort de la tranche de taille stride[d + 1] : on y revient sans modulo.
+    const uint back = ((lat.wrap[site] >> k) & 1) * lat.stride[d + 1];
+    return (k & 1) ? site - lat.stride[d] + back : site + lat.stride[d] - back;
+}
+
+/// @brief Somme des spins voisins d'un site d'un réseau de dimension quelconque.
+/// @param lat Réseau de spin
+/// @param site Indice du site
+/// @return Champ local (en unité de J)
+inline int hypercubeField(const Lattice &lat, const uint site) {
+    int field = 0;
+    for (uint k = 0; k < 2 * lat.dimension; k++) {
+        field += lat.spin[hypercubeNeighbor(lat, site, k)];
+    }
+    return field;
+}
+
+/// @brief Retourne l'indice du site de coordonnées (x, y) en tenant compte de la périodicité.
+/// @param lat Réseau de spin
+/// @param x Coordonnée x
+/// @param y Coordonnée y
+/// @return Indice du site dans le tableau de spins
+uint siteIndex(Lattice &lat, const int x, const int y);
+
 /// @brief Retourne l'adresse mémoire d'un site de spin de coordonnées (x, y) en tenant compte de la périodicité.
 /// @param lat Réseau de spin à considérer
 /// @param x Coordoonée x
 /// @param y Coordonnée y
 /// @return Adresse mémoire du spin en (x, y)
-int *_getSpinRef(Lattice &lat, const int x, const int y);
+int8_t *_getSpinRef(Lattice &lat, const int x, const int y);
 
 /// @brief Retourne le spin d'un site de coordonnées (x, y) en tenant compte de la périodicité.
 /// @param lat Réseau de spin à considérer
@@ -54,6 +207,11 @@ void setSpin(Lattice &lat, const int x, const int y, const int spinValue);
 /// @param y Coordonnée y
 void flipSpin(Lattice &lat, const int x, const int y);
 
+/// @brief Retourne le spin d'indice donné.
+/// @param lat Réseau de spin à considérer
+/// @param site Indice du site
+void flipSpin(Lattice &lat, const uint site);
+
 /// @brief Initialise l'ensemble du réseau avec des spins de même sens et norme
 /// @param lat Le réseau de spin à initialiser
 /// @param spinValueValeur du spin à attribuer sur l'ensemble du réseau
@@ -64,7 +222,7 @@ void uniformSpin(Lattice &lat, const int spinValue);
 /// @param p Probabilité qu'un spin soit UP
 void randomSpin(Lattice &lat, const double p);
 
-/// @brief Détermine l'hamiltonien du réseau entier
+/// @brief Détermine l'hamiltonien du réseau entier (par popcount si le réseau est compacté)
 /// @param lat Réseau de spin
 /// @param J Paramètre de couplage entre spin
 /// @return Energie du réseau
@@ -72,13 +230,20 @@ double latticeEnergy(Lattice &lat, double J, double h);
 
 /// @brief Calcule le gain d'énergie en cas de spin-flip
 /// @param lat Réseau de spin
-/// @param x Coordonnée x du spin à retourner 
+/// @param x Coordonnée x du spin à retourner
 /// @param y Coordonnée y du spin à retourner
 /// @param J Paramètre de couplage entre spin
 /// @return Gain d'énergie pour le réseau en cas d'énergie (E > 0 <=> Destabilisation, E < 0 <=> Stabilisation)
 double swappingEnergy(Lattice &lat, const int x, const int y, double J, double h);
 
-/// @brief Calcule le taux de magnétisation du milieu
+/// @brief Calcule le gain d'énergie en cas de spin-flip du site d'indice donné
+/// @param lat Réseau de spin
+/// @param site Indice du spin à retourner
+/// @param J Paramètre de couplage entre spin
+/// @return Gain d'énergie pour le réseau en cas d'énergie (E > 0 <=> Destabilisation, E < 0 <=> Stabilisation)
+double swappingEnergy(Lattice &lat, const uint site, double J, double h);
+
+/// @brief Calcule le taux de magnétisation du milieu (par popcount si le réseau est compacté)
 /// @param lat Réseau de spin
 /// @return Magnétisation du milieu
 double magnetization(Lattice &lat);
@@ -88,8 +253,14 @@ double magnetization(Lattice &lat);
 /// @return Changement de la magnétisation du milieu
 double swappingMagnetization(Lattice &lat, const int x, const int y);
 
+/// @brief Calcule le changement de magnétisation du milieu en cas de spin-flip du site d'indice donné
+/// @param lat Réseau de spin
+/// @param site Indice du spin à retourner
+/// @return Changement de la magnétisation du milieu
+double swappingMagnetization(Lattice &lat, const uint site);
+
 int pcx(Lattice &lat, int i);
 
 int pcy(Lattice &lat, int i);
 
-}
\ No newline at end of file
+}
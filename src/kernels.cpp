@@ -0,0 +1,53 @@
+#include "kernels.hpp"
+#include "hypercube.hpp"
+
+#include <array>
+#include <utility>
+
+namespace MC {
+
+typedef void (*Iterator)(Ising::Lattice&, Parameters&, double&, double&);
+
+/// @brief Instanciations metropolisKernel<D, 2^(FIRST + k)> pour k de 0 à sizeof...(K) - 1.
+template <uint D, uint FIRST, size_t... K>
+static constexpr std::array<Iterator, sizeof...(K)> instances(std::index_sequence<K...>) {
+    return { metropolisKernel<D, (1u << (FIRST + K))>... };
+}
+
+// * Côtés 2^4 à 2^12 en 2D, 2^4 à 2^20 sites en 1D.
+static const auto kernels2D = instances<2, 4>(std::make_index_sequence<9>());
+static const auto kernels1D = instances<1, 4>(std::make_index_sequence<17>());
+
+Iterator specializedMetropolis(const Ising::Lattice &lat) {
+    if (lat.neighbor == nullptr) {
+        return hypercubeMetropolisIteration;
+    }
+    const uint size = lat.sizeX;
+    if (size < 16 || (size & (size - 1)) != 0 || lat.bits != nullptr) {
+        return metropolisIteration;
+    }
+
+    const uint k = __builtin_ctz(size) - 4;
+    if (lat.sizeY == size && k < kernels2D.size()) {
+        return kernels2D[k];
+    }
+    if (lat.sizeY == 1 && k < kernels1D.size()) {
+        return kernels1D[k];
+    }
+    return metropolisIteration;
+}
+
+Iterator genericIterator(Iterator iterator) {
+    for (Iterator kernel : kernels2D) {
+        if (kernel == iterator) {
+            return metropolisIteration;
+        }
+    }
+    for (Iterator kernel : kernels1D) {
+        if (kernel == iterator) {
+            return metropolisIteration;
+        }
+    }
+    return iterator;
+}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Noyaux spécialisés à la compilation : la dimension, le côté du réseau (puissance de 2) et le type de stockage des
+// spins sont des paramètres de template. Les repliements périodiques deviennent des masques constexpr, la somme des
+// voisins n'a ni branchement ni accès à la table des voisins, et le cas 1D n'est plus testé à chaque accès.
+// Le choix de l'instanciation se fait une seule fois par simulation (specializedMetropolis).
+
+namespace MC {
+
+/// @brief Géométrie d'un réseau hypercubique périodique de côté SIZE (puissance de 2) en dimension D (1 ou 2),
+/// stocké ligne par ligne comme Ising::Lattice.
+/// @tparam D Dimension
+/// @tparam SIZE Côté du réseau
+/// @tparam Spin Type de stockage d'un spin
+template <uint D, uint SIZE, typename Spin = int8_t>
+struct Geometry {
+    static_assert(D == 1 || D == 2, "Dimension 1 ou 2");
+    static_assert(SIZE >= 2 && (SIZE & (SIZE - 1)) == 0, "Côté puissance de 2");
+
+    static constexpr uint shift = __builtin_ctz(SIZE);
+    static constexpr uint mask = SIZE - 1;
+    static constexpr uint siteBits = D * shift;
+    static constexpr uint siteCount = 1u << siteBits;
+
+    /// @brief Somme des spins voisins d'un site, repliements par masques.
+    static inline int field(const Spin *spin, const uint site) {
+        const uint x = site & mask;
+        const uint row = site - x;
+        int sum = spin[row + ((x + 1) & mask)] + spin[row + ((x - 1) & mask)];
+        if constexpr (D == 2) {
+            sum += spin[(site + SIZE) & (siteCount - 1)] + spin[(site - SIZE) & (siteCount - 1)];
+        }
+        return sum;
+    }
+
+    /// @brief Site uniforme : les bits de poids fort d'un tirage suffisent, sans rejet, pour un nombre de sites puissance de 2.
+    static inline uint randomSite(RNG::Generator &rng) {
+        return RNG::next(rng) >> (64 - siteBits);
+    }
+};
+
+/// @brief Itération de Metropolis spécialisée, mêmes règles que metropolisIteration.
+/// Le réseau doit avoir la géométrie Geometry<D, SIZE> : D = 2 et sizeX = sizeY = SIZE, ou D = 1 et sizeX = SIZE.
+template <uint D, uint SIZE>
+void metropolisKernel(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    typedef Geometry<D, SIZE, int8_t> G;
+    updateAcceptance(options);
+    const uint site = G::randomSite(lat.rng);
+
+    const int spin = lat.spin[site];
+    const int k = tableIndex(G::field(lat.spin, site), spin);
+    deltaE = options.table.deltaE[k];
+    deltaM = - 2 * spin;
+
+    TELEMETRY_ADD(attempts, 1);
+    if (deltaE <= 0 || RNG::uniform(lat.rng) < options.table.probability[k]) {
+        lat.spin[site] = -spin;
+        TELEMETRY_ADD(accepted, 1);
+    }
+    else {
+        deltaE = 0;
+        deltaM = 0;
+    }
+}
+
+/// @brief Choisit l'itération de Metropolis la plus spécialisée pour la géométrie du réseau : une instanciation de
+/// metropolisKernel pour un réseau 2D carré de côté 16 à 4096 ou un réseau 1D de 16 à 2^20 sites (puissances de 2),
+/// hypercubeMetropolisIteration pour un réseau de dimension 3 ou 4, metropolisIteration sinon. A appeler une fois, avant la simulation : options.mcIterator = specializedMetropolis(lat).
+/// @param lat Réseau de spin
+/// @return Itération à utiliser comme options.mcIterator
+void (*specializedMetropolis(const Ising::Lattice &lat))(Ising::Lattice&, Parameters&, double&, double&);
+
+/// @brief Itération générique correspondant à une itération éventuellement spécialisée (metropolisIteration pour une
+/// instanciation de metropolisKernel, l'itération elle-même sinon). Sert à enregistrer les paramètres d'une simulation.
+void (*genericIterator(void (*iterator)(Ising::Lattice&, Parameters&, double&, double&)))(Ising::Lattice&, Parameters&, double&, double&);
+}
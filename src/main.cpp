@@ -3,31 +3,27 @@
 #include "colormap.hpp"
 #include "ising.hpp"
 #include "montecarlo.hpp"
+#include "checkerboard.hpp"
+#include "multispin.hpp"
+#include "parallel.hpp"
+#include "tempering.hpp"
+#include "domain.hpp"
+#include "distributed.hpp"
+#include "checkpoint.hpp"
+#include "telemetry.hpp"
+#include "kernels.hpp"
+#include "hypercube.hpp"
+#include "heatbath.hpp"
+#include "nfold.hpp"
+#include "reweighting.hpp"
+#include "wanglandau.hpp"
+#include "batch.hpp"
 #include <ctime>
-#include <fstream>
 #include <iostream>
 #include <unistd.h>  
 
 void saveProps(Ising::Lattice &lat, MC::Parameters options, MC::Properties props, uint samplingPoints, std::string fileName) {
-    std::fstream file;
-    file.open("res/" + fileName, std::ios::out);
-
-    double norm, nr2;
-
-    for (uint i = 0; i < samplingPoints; i++)
-    {
-        norm = 1/(lat.sizeXY * lat.neighborCount * props.mcSteps[i]);
-        nr2 = norm / props.mcSteps[i];
-        file << props.T[i] << ";";
-        file << norm * props.E[i]<< ";";
-        file << norm * props.E_sq[i]<< ";";
-        file << norm * props.M[i] << ";"; 
-        file << norm * props.M_sq[i] << ";"; 
-        file << norm * props.M_abs[i] << ";";
-        file << (norm * props.E_sq[i] - nr2 * props.E[i] * props.E[i]) / (options.kB * props.T[i]) / (options.kB * props.T[i]) << ";";
-        file << (norm * props.M_sq[i] - nr2 * props.M[i] * props.M[i]) / (options.kB * props.T[i]) << "\n";
-    }
-    file.close();
+    Batch::writeProps("res/" + fileName, lat, options.kB, props, samplingPoints);
 }
 
 /// @brief Fonction pour montrer visuellement l'évolution du système.
@@ -35,6 +31,7 @@ void showAlgorithm(Ising::Lattice &lat, MC::Parameters options, double Ti, doubl
     plt::ion();
     double deltaT = abs(Tf - Ti) / samplingPoints;
 
+    // * Le tableau Numpy partage la mémoire du réseau : il suit les spins sans être recréé à chaque image.
     auto spin = np::array(lat.spin, lat.sizeY, lat.sizeX);
     
     double E = Ising::latticeEnergy(lat, options.J, options.h);
@@ -51,7 +48,6 @@ void showAlgorithm(Ising::Lattice &lat, MC::Parameters options, double Ti, doubl
                 plt::xlabel("X");
                 plt::ylabel("Y");
                 plt::title("T=" + std::to_string(options.T) + "; X=" + std::to_string(M));
-                np::array(spin, lat.spin, lat.sizeY, lat.sizeX);
                 plt::imshow(spin, CMAP_seismic);
                 plt::colorbar(); 
                 plt::pause();
@@ -67,17 +63,91 @@ void showAlgorithm(Ising::Lattice &lat, MC::Parameters options, double Ti, doubl
 }
 
 
+#ifdef ISING_MPI
+/// @brief Simulation d'un seul grand réseau réparti sur tous les rangs MPI (make mpi).
+int mpiMain(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+
+    // * Tous les rangs doivent partager la même graine : celle du rang 0 est diffusée.
+    uint64_t seed = std::time(NULL);
+    MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+    Ising::Lattice slab = Distributed::slab(256, 256, seed);
+    Ising::randomSpin(slab, 0.5);
+
+    MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, Distributed::mpiIteration, 0.1, 1, 0, 1);
+    options.seed = seed;
+
+    uint samplingPoints = 100;
+    MC::Properties propsTemp = Distributed::thermalizeLattice(slab, options, 0.1, 5, samplingPoints);
+
+    options.T = 4;
+    MC::Properties propsMagn = Distributed::magnetizeLattice(slab, options, -5, 5, samplingPoints);
+
+    // * saveProps ne lit que la taille du réseau global.
+    if (Distributed::context().rank == 0) {
+        Ising::Lattice global = Ising::Lattice();
+        global.sizeXY = (double)Distributed::context().sizeX * Distributed::context().sizeY;
+        global.neighborCount = 2;
+        saveProps(global, options, propsTemp, samplingPoints, "temp_data.csv");
+        saveProps(global, options, propsMagn, samplingPoints, "magn_data.csv");
+    }
+
+    Ising::freeLattice(slab);
+    MPI_Finalize();
+    return 0;
+}
+#endif
+
 int main(int argc, char *argv[]) {
-    std::srand(std::time(NULL));
+#ifdef ISING_MPI
+    return mpiMain(argc, argv);
+#endif
+    // * Avec des arguments : exécution d'un lot de tâches (voir batch.hpp), par exemple
+    // * ./build/isingModel --threads 8 jobs.txt --job "L=16,32 algorithm=wolff sweep=T from=1 to=4 seed=1..4"
+    if (argc > 1) {
+        return Batch::main(argc, argv);
+    }
+    const uint64_t seed = std::time(NULL);
     py::openPython();    
+#ifdef ISING_TELEMETRY
+    Telemetry::startDump("res/metrics.txt", 10);
+#endif
 
-    // * Initialisation du réseau de spin
+    // * Initialisation du réseau de spin, avec son propre flux aléatoire dérivé de la graine
     Ising::Lattice lat = Ising::lattice(16, 16);
+    // * Réseau hypercubique 3D ou 4D, avec MC::hypercubeMetropolisIteration, MC::hypercubeWolffIteration ou MC::hypercubeCheckerboardIteration.
+    // Ising::Lattice lat = Ising::hypercube(16, 3);
+    Ising::seed(lat, seed, 0);
     Ising::randomSpin(lat, 0.5);
 
     // * Création des paramètres de simulation
     MC::Parameters options = MC::parameters(2.5e6, 150000, 0.5, 0.0002, MC::metropolisIteration, 0.1, 1, 0, 1);
     // MC::Parameters options = MC::parameters(500, 100, 2, 0.0002, MC::wolffIteration, 0.01, 1, 0, 1);
+    // * Metropolis spécialisé à la compilation pour la géométrie du réseau (choisi une seule fois).
+    // options.mcIterator = MC::specializedMetropolis(lat);
+    // MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, MC::checkerboardIteration, 0.1, 1, 0, 1);
+    // * Bain thermique (Glauber), site aléatoire (MC::heatBathIteration) ou balayage séquentiel (MC::heatBathSweepIteration).
+    // MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, MC::heatBathSweepIteration, 0.1, 1, 0, 1);
+    // * n-fold way sans rejet, une itération par balayage (mcSteps reste compté en tentatives de Metropolis).
+    // MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, MC::nFoldIteration, 0.1, 1, 0, 1);
+    // options.iterationSteps = lat.siteCount;
+    // * Codage multi-spin : sizeX multiple de 64, réseau compacté avant la simulation (h = 0 uniquement).
+    // Ising::packLattice(lat);
+    // MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, MC::multiSpinIteration, 0.1, 1, 0, 1);
+    // * Décomposition de domaine d'un grand réseau sur tous les coeurs (réseau 2D de tailles paires).
+    // MC::Parameters options = MC::parameters(20000, 1000, 0.5, 0.0002, MC::domainIteration, 0.1, 1, 0, 1);
+    // options.threads = Parallel::hardwareThreads();
+    // MC::domainPlace(lat, options.threads);
+    options.seed = seed;
+    // * Mesures espacées selon le temps d'autocorrélation, chaque point s'arrête à 0.5% d'erreur relative sur <E> et <|M|>.
+    // options.targetError = 0.005;
+    // * Détection d'équilibre sur fenêtre glissante (ou MC::gewekeEquilibrium, MC::hotColdEquilibrium).
+    // options.equilibrator = MC::mserEquilibrium;
+    // * Série temporelle (T, h, E, M) compressée, écrite par un thread dédié ; Series::exportCsv pour la relire en texte.
+    // Series::Writer series("res/series.bin", 1 << 16, true);
+    // options.series = &series;
+    // options.seriesStride = lat.siteCount;
 
     // * Démonstration de l'algorithme visuellement
     // showAlgorithm(lat, options, 0.1, 5, 20);
@@ -85,7 +155,25 @@ int main(int argc, char *argv[]) {
     // * Génération des données pour T qui varie
     uint samplingPoints = 100;
     MC::Properties propsTemp = MC::thermalizeLattice(lat, options, 0.1, 5, samplingPoints);
+    // * Variante parallèle : un réseau et un flux par chaîne de points, répartis sur tous les coeurs.
+    // options.threads = Parallel::hardwareThreads();
+    // MC::Properties propsTemp = MC::thermalizeLatticeParallel(lat, options, 0.1, 5, samplingPoints, 1);
+    // * Echange de répliques : une réplique par température, échanges toutes les 10 itérations.
+    // MC::ExchangeStats exchangeStats;
+    // MC::Properties propsTemp = MC::parallelTempering(lat, options, 0.1, 5, samplingPoints, 20000, 10, exchangeStats);
+    // * Avec point de reprise tous les 5 points : relancer le programme reprend le balayage là où il s'est arrêté.
+    // MC::Properties propsTemp = Checkpoint::thermalizeLattice(lat, options, 0.1, 5, samplingPoints, "res/temp.ckp", 5);
     saveProps(lat, options, propsTemp, samplingPoints, "temp_data.csv");
+    // * Repondération : 5 à 10 points simulés avec série temporelle (options.series), puis une grille fine sans simulation.
+    // std::vector<Reweighting::Run> runs;
+    // Reweighting::read("res/series.bin", runs);
+    // MC::Properties propsReweighted = Reweighting::multiHistogram(runs, options.kB, 2, 2.6, 200);
+    // saveProps(lat, options, propsReweighted, 200, "reweighted_data.csv");
+    // * Densité d'états de Wang-Landau (h = 0), 4 fenêtres en parallèle : toutes les températures en une seule estimation.
+    // WangLandau::Parameters wlParams = WangLandau::parameters(1e-6, 4, options.J, seed);
+    // wlParams.threads = Parallel::hardwareThreads();
+    // MC::Properties propsDos = WangLandau::thermodynamics(WangLandau::estimate(lat, wlParams), options.kB, 0.1, 5, samplingPoints);
+    // saveProps(lat, options, propsDos, samplingPoints, "dos_data.csv");
 
     // * Génération des données pour h qui varie
     options.T = 4;
@@ -93,25 +181,17 @@ int main(int argc, char *argv[]) {
     saveProps(lat, options, propsMagn, samplingPoints, "magn_data.csv");
 
     py::closePython();
+#ifdef ISING_TELEMETRY
+    Telemetry::stopDump();
+#endif
 
     // ! Les free sont inutiles dans ce programme, les tableaux sont nécessaires et persistent tout le long
     // ! de la durée de vie du programme. Les tableaux seront libérés automatiquement par le noyau.
 
-    free(lat.spin);
-
-    free(propsTemp.E);
-    free(propsTemp.E_sq);
-    free(propsTemp.M);
-    free(propsTemp.M_sq);
-    free(propsTemp.mcSteps);
-    free(propsTemp.T);
-
-    free(propsMagn.E);
-    free(propsMagn.E_sq);
-    free(propsMagn.M);
-    free(propsMagn.M_sq);
-    free(propsMagn.mcSteps);
-    free(propsMagn.T);
+    Ising::freeLattice(lat);
+
+    MC::freeProperties(propsTemp);
+    MC::freeProperties(propsMagn);
 
     return 0;
 }   
\ No newline at end of file
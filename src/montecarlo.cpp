@@ -1,5 +1,13 @@
 #include "montecarlo.hpp"
 
+#include "parallel.hpp"
+#include "stats.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace MC {
 Parameters parameters(uint epochTreshold, uint jumpSize, double dataRecordDuration, double relativeVariation, void (*mcIterator)(Ising::Lattice&, Parameters&, double&, double&), double T, double J, double h, double kB) {
     Parameters options = Parameters();
@@ -12,26 +20,54 @@ Parameters parameters(uint epochTreshold, uint jumpSize, double dataRecordDurati
     options.relativeVariation = relativeVariation;
     options.dataRecordDuration = dataRecordDuration;
     options.mcIterator = mcIterator;
+    options.threads = 1;
+    options.targetError = 0;
+    options.iterationSteps = 1;
+    options.series = nullptr;
+    options.seriesStride = 1;
+
+    // * Table invalide : elle sera construite au premier appel de updateAcceptance.
+    options.table.T = NAN;
 
     return options;
 }
 
-Site makeSite(Ising::Lattice &lat, int x, int y) {
-    Site out = Site();
-    out.first = Ising::pcx(lat, x);
-    out.second = Ising::pcy(lat, y);
-    return out;
+void updateAcceptance(Parameters &options) {
+    AcceptanceTable &table = options.table;
+    if (table.T == options.T && table.J == options.J && table.h == options.h && table.kB == options.kB) {
+        return;
+    }
+
+    table.T = options.T;
+    table.J = options.J;
+    table.h = options.h;
+    table.kB = options.kB;
+
+    // * Le champ local a toujours la parité du nombre de voisins (pair en toute dimension) : seules les valeurs paires existent.
+    for (int field = -Ising::MAX_NEIGHBORS; field <= Ising::MAX_NEIGHBORS; field += 2) {
+        for (int spin = DOWN; spin <= UP; spin += 2) {
+            const int k = tableIndex(field, spin);
+            table.deltaE[k] = 2 * options.J * spin * field + 2 * options.h * spin;
+            table.probability[k] = std::min(1.0, std::exp(-table.deltaE[k] / (options.kB * options.T)));
+            table.heatBath[k] = 1 / (1 + std::exp(table.deltaE[k] / (options.kB * options.T)));
+        }
+    }
+
+    table.bondProbability = 1 - std::exp(- 2 * options.J / (options.kB * options.T));
 }
 
 void metropolisIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
-    int randomX = std::rand() % lat.sizeX;
-    int randomY = std::rand() % lat.sizeY;
+    updateAcceptance(options);
+    uint randomSite = RNG::bounded(lat.rng, lat.siteCount);
 
-    deltaE = Ising::swappingEnergy(lat, randomX, randomY, options.J, options.h);
-    deltaM = Ising::swappingMagnetization(lat, randomX, randomY);
+    const int k = tableIndex(Ising::localField(lat, randomSite), lat.spin[randomSite]);
+    deltaE = options.table.deltaE[k];
+    deltaM = Ising::swappingMagnetization(lat, randomSite);
     
-    if (deltaE <= 0 || (double)std::rand() / RAND_MAX < std::exp(-deltaE/(options.kB * options.T))) {
-        Ising::flipSpin(lat, randomX, randomY);
+    TELEMETRY_ADD(attempts, 1);
+    if (deltaE <= 0 || RNG::uniform(lat.rng) < options.table.probability[k]) {
+        Ising::flipSpin(lat, randomSite);
+        TELEMETRY_ADD(accepted, 1);
     }
     else {
         deltaE = 0;
@@ -39,111 +75,253 @@ void metropolisIteration(Ising::Lattice &lat, Parameters &options, double &delta
     }
 }
 
-void tryNeighbor(Ising::Lattice &lat, Parameters &options, std::stack<Site> &stack, std::map<Site, int> &cluster, int neighbor_x, int neighbor_y, int spin0) {
-    Site neighbor = makeSite(lat, neighbor_x, neighbor_y);
-    
-    if (spin0 != Ising::getSpin(lat, neighbor_x, neighbor_y)) {
-        // std::cout << "[Neighbor] Refusing neighbor (opposite spin): (" << neighbor_x << "," << neighbor_y << ")\n";
-        return;
-    }
-    if (cluster.count(neighbor) != 0) {
-        // std::cout << "[Neighbor] Refusing neighbor (in cluster): (" << neighbor_x << "," << neighbor_y << ")\n";
-        return;
+bool acceptCluster(Ising::Lattice &lat, Parameters &options, const int spin0, const uint *cluster, const uint clusterSize) {
+    if (options.h * spin0 <= 0 || RNG::uniform(lat.rng) < std::exp(- 2 * options.h * spin0 * clusterSize / (options.kB * options.T))) {
+        return true;
     }
-    
-    int isNeighborAccepted = (double)std::rand() / RAND_MAX < 1 - std::exp(- 2 * options.J / (options.kB * options.T));
-    if (isNeighborAccepted) {
-        // std::cout << "[Neighbor] Adding to stack site : (" << neighbor_x << "," << neighbor_y << ")\n";        
-        stack.push(neighbor);
+    for (uint j = 0; j < clusterSize; j++) {
+        lat.spin[cluster[j]] = spin0;
     }
+    return false;
 }
 
 void wolffIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
-    assert(options.h == 0);
+    updateAcceptance(options);
+    Ising::allocateWorkspace(lat);
+
+    const double bondProbability = options.table.bondProbability;
+    int8_t *spin = lat.spin;
+    uint *stack = lat.stack;
+    uint *stamp = lat.stamp;
+    // * Sites retournés, dans l'ordre, pour défaire le cluster s'il est rejeté.
+    uint *cluster = lat.label;
+
+    // * Nouvelle époque : un site appartient au cluster courant ssi stamp == epoch.
+    if (++lat.epoch == 0) {
+        std::fill(stamp, stamp + lat.siteCount, 0);
+        lat.epoch = 1;
+    }
+    const uint epoch = lat.epoch;
 
     // Spin initial
-    int randomX = std::rand() % lat.sizeX;
-    int randomY = std::rand() % lat.sizeY;
-    int spin0 = Ising::getSpin(lat, randomX, randomY);
+    const uint seed = RNG::bounded(lat.rng, lat.siteCount);
+    const int spin0 = spin[seed];
 
-    // Suivi de la construction du cluster
-    Site visitedSite;
-    std::stack<Site> stack;
-    std::map<Site, int> cluster;
-    stack.push(makeSite(lat, randomX, randomY));
+    uint top = 0;
+    stack[top++] = seed;
+    stamp[seed] = epoch;
 
     // Suivi du cluster en temps réel
-    int clusterSize = 0;
-    int clusterNeighbor = 0;
-
-    while(!stack.empty()) {
-        visitedSite = stack.top();
-        stack.pop();
-
-        if (spin0 == Ising::getSpin(lat, visitedSite.first, visitedSite.second)) {
-            // std::cout << "[Wolff] Visited site = " << visitedSite.first << ";" << visitedSite.second << "; spin =" << Ising::getSpin(lat, visitedSite.first, visitedSite.second) << "\n";
-            
-            cluster[visitedSite] = 1;
-            clusterSize++;
-
-            tryNeighbor(lat, options, stack, cluster, visitedSite.first + 1, visitedSite.second, spin0);
-            tryNeighbor(lat, options, stack, cluster, visitedSite.first - 1, visitedSite.second, spin0);
-            tryNeighbor(lat, options, stack, cluster, visitedSite.first, visitedSite.second + 1, spin0);
-            tryNeighbor(lat, options, stack, cluster, visitedSite.first, visitedSite.second - 1, spin0);
+    uint clusterSize = 0;
+    int64_t clusterField = 0;
+
+    while (top > 0) {
+        const uint site = stack[--top];
+        const uint *n = lat.neighbor + Ising::NEIGHBORS * site;
+
+        int field = 0;
+        for (uint k = 0; k < Ising::NEIGHBORS; k++) {
+            const uint next = n[k];
+            field += spin[next];
+            // * Un voisin déjà retourné a le spin opposé, un voisin déjà empilé porte l'époque courante.
+            if (spin[next] == spin0 && stamp[next] != epoch && RNG::uniform(lat.rng) < bondProbability) {
+                stamp[next] = epoch;
+                stack[top++] = next;
+            }
         }
+
+        // * Retourner les sites un à un : la somme des ΔE successifs est exactement le ΔE du cluster.
+        clusterField += field;
+        spin[site] = -spin0;
+        cluster[clusterSize++] = site;
+    }
+
+    TELEMETRY_CLUSTER(clusterSize);
+    TELEMETRY_ADD(attempts, clusterSize);
+    lat.clusterSize = clusterSize;
+
+    if (!acceptCluster(lat, options, spin0, cluster, clusterSize)) {
+        deltaE = 0;
+        deltaM = 0;
+        return;
     }
 
     // On rejete les clusters  qui reviennent quasiment à une simple symétrie du système.
     if (clusterSize > 0.8 * lat.sizeXY) {
+        for (uint j = 0; j < clusterSize; j++) {
+            spin[cluster[j]] = spin0;
+        }
         deltaE = 0;
         deltaM = 0;
         return;
     }
 
-    // Calcul des voisins du cluster
-    Site neighbor = makeSite(lat, 0, 0);
-    for (const auto& [key, val] : cluster) {
-        neighbor.first = Ising::pcx(lat, key.first + 1);
-        neighbor.second = Ising::pcy(lat, key.second);
-        if (cluster.count(neighbor) == 0) {
-            clusterNeighbor += Ising::getSpin(lat, key.first + 1, key.second);
-        }
+    TELEMETRY_ADD(accepted, clusterSize);
+    // * Terme d'échange et terme de champ : -h Σ s varie de 2h spin0 par site retourné.
+    deltaE = 2 * options.J * spin0 * clusterField + 2 * options.h * spin0 * (double)clusterSize;
+    deltaM = - 2 * (double)clusterSize * spin0;
+}
 
-        neighbor.first = Ising::pcx(lat, key.first - 1);
-        neighbor.second = Ising::pcy(lat, key.second);
-        if (cluster.count(neighbor) == 0) {
-            clusterNeighbor += Ising::getSpin(lat, key.first - 1, key.second);
-        }
+/// @brief Racine d'un site dans la forêt union-find, avec compression de chemin par division.
+static inline uint findRoot(uint *parent, uint site) {
+    while (parent[site] != site) {
+        parent[site] = parent[parent[site]];
+        site = parent[site];
+    }
+    return site;
+}
+
+/// @brief Réunit les clusters de deux sites : la racine d'indice le plus grand pointe vers l'autre.
+static inline void unite(uint *parent, const uint a, const uint b) {
+    const uint rootA = findRoot(parent, a);
+    const uint rootB = findRoot(parent, b);
+    if (rootA < rootB) {
+        parent[rootB] = rootA;
+    }
+    else if (rootB < rootA) {
+        parent[rootA] = rootB;
+    }
+}
+
+/// @brief Equipe de threads de l'étiquetage par bandes, créée au premier appel et recréée si le nombre de bandes change.
+/// Une équipe par thread appelant : deux simulations concurrentes ne se la disputent pas et ne la détruisent pas en cours d'usage.
+static Parallel::Team &labelTeam(uint threads) {
+    thread_local std::unique_ptr<Parallel::Team> team;
+    if (!team || team->size() != threads) {
+        team.reset(new Parallel::Team(threads));
+    }
+    return *team;
+}
+
+/// @brief Place les liaisons internes aux lignes [y0, y1) et étiquette les clusters de la bande.
+/// Seuls les sites de la bande sont lus et écrits dans parent : les bandes peuvent être traitées en parallèle.
+static void labelStrip(Ising::Lattice &lat, const double bondProbability, RNG::Generator rng, const uint y0, const uint y1) {
+    const int8_t *spin = lat.spin;
+    uint *parent = lat.label;
+
+    for (uint i = y0 * lat.sizeX; i < y1 * lat.sizeX; i++) {
+        parent[i] = i;
+    }
 
-        neighbor.first = Ising::pcx(lat, key.first);
-        neighbor.second = Ising::pcy(lat, key.second + 1);
-        if (cluster.count(neighbor) == 0) {
-            clusterNeighbor += Ising::getSpin(lat, key.first, key.second + 1);
+    for (uint y = y0; y < y1; y++) {
+        for (uint i = y * lat.sizeX; i < (y + 1) * lat.sizeX; i++) {
+            const uint right = Ising::neighbor(lat, i, Ising::XPLUS);
+            if (spin[i] == spin[right] && RNG::uniform(rng) < bondProbability) {
+                unite(parent, i, right);
+            }
+            if (y + 1 < y1) {
+                const uint down = Ising::neighbor(lat, i, Ising::YPLUS);
+                if (spin[i] == spin[down] && RNG::uniform(rng) < bondProbability) {
+                    unite(parent, i, down);
+                }
+            }
         }
+    }
+}
+
+void swendsenWangIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(options.h == 0);
+    updateAcceptance(options);
+    Ising::allocateWorkspace(lat);
+
+    const double bondProbability = options.table.bondProbability;
+    const uint sizeX = lat.sizeX;
+    const uint sizeY = lat.sizeY;
+    const int8_t *spin = lat.spin;
+    uint *parent = lat.label;
+
+    // * Découpage en bandes de lignes, chacune avec son propre flux dérivé de celui du réseau.
+    const uint strips = std::max(1u, std::min(options.threads, sizeY / 2));
+    const uint64_t stripSeed = RNG::next(lat.rng);
+    std::vector<uint> bounds(strips + 1);
+    for (uint s = 0; s <= strips; s++) {
+        bounds[s] = s * sizeY / strips;
+    }
 
-        neighbor.first = Ising::pcx(lat, key.first);
-        neighbor.second = Ising::pcy(lat, key.second - 1);
-        if (cluster.count(neighbor) == 0) {
-            clusterNeighbor += Ising::getSpin(lat, key.first, key.second - 1);
+    if (strips == 1) {
+        labelStrip(lat, bondProbability, RNG::generator(stripSeed, 0), 0, sizeY);
+    }
+    else {
+        // * Un balayage est court : les bandes tournent sur une équipe persistante plutôt que sur des threads créés à chaque appel.
+        labelTeam(strips).run([&](uint s) {
+            labelStrip(lat, bondProbability, RNG::generator(stripSeed, s), bounds[s], bounds[s + 1]);
+        });
+    }
+
+    // * Liaisons entre la dernière ligne d'une bande et la suivante (y compris le repliement périodique).
+    if (sizeY > 1) {
+        for (uint s = 0; s < strips; s++) {
+            const uint y = bounds[s + 1] - 1;
+            for (uint i = y * sizeX; i < (y + 1) * sizeX; i++) {
+                const uint down = Ising::neighbor(lat, i, Ising::YPLUS);
+                if (spin[i] == spin[down] && RNG::uniform(lat.rng) < bondProbability) {
+                    unite(parent, i, down);
+                }
+            }
         }
+    }
+
+    // * Etiquette finale = racine ; taille des clusters dans stack.
+    uint *size = lat.stack;
+    std::fill(size, size + lat.siteCount, 0);
+    for (uint i = 0; i < lat.siteCount; i++) {
+        parent[i] = findRoot(parent, i);
+        size[parent[i]]++;
+    }
 
-        Ising::flipSpin(lat, key.first, key.second);
+    // * Chaque racine tire son retournement ; stack contient ensuite 1 pour les clusters retournés.
+    double moment = 0;
+    for (uint i = 0; i < lat.siteCount; i++) {
+        if (parent[i] == i) {
+            moment += (double)size[i] * size[i];
+            size[i] = RNG::next(lat.rng) >> 63;
+        }
+    }
+    lat.clusterMoment = moment / lat.siteCount;
+
+    // * ΔE : seules les liaisons entre un site retourné et un site qui ne l'est pas changent de signe.
+    const uint *flipped = size;
+    const uint directions[] = { Ising::XPLUS, Ising::YPLUS };
+    const uint directionCount = sizeY > 1 ? 2 : 1;
+    int64_t bondChange = 0;
+    int64_t magnetizationChange = 0;
+    uint64_t flippedSites = 0;
+
+    for (uint i = 0; i < lat.siteCount; i++) {
+        const int flip = flipped[parent[i]];
+        flippedSites += flip;
+        for (uint d = 0; d < directionCount; d++) {
+            const uint next = Ising::neighbor(lat, i, directions[d]);
+            if (flip != (int)flipped[parent[next]]) {
+                bondChange += spin[i] * spin[next];
+            }
+        }
+        magnetizationChange -= flip * 2 * spin[i];
     }
 
-    // std::cout << "[Wolff] Cluster Neighbor = " << clusterNeighbor << "\n";
-    // std::cout << "[Wolff] Cluster Spin = " << clusterSize * spin0 << "\n";
-    // std::cout << "[Wolff] Cluster Size = " << clusterSize << "\n";
+    for (uint i = 0; i < lat.siteCount; i++) {
+        lat.spin[i] *= 1 - 2 * (int)flipped[parent[i]];
+    }
 
-    deltaE = 2 * options.J * spin0 * clusterNeighbor;
-    deltaM = - 2 * clusterSize * spin0;
+    TELEMETRY_ADD(attempts, lat.siteCount);
+    TELEMETRY_ADD(accepted, flippedSites);
+    deltaE = 2 * options.J * bondChange;
+    deltaM = magnetizationChange;
 }
 
-int atEquilibrium(Ising::Lattice &lat, Parameters &options, int oldEnergy, int newEnergy) {
-    return fabs((newEnergy - oldEnergy) / (double)newEnergy) < options.relativeVariation;
+int atEquilibrium(Ising::Lattice &lat, Parameters &options, double oldEnergy, double newEnergy) {
+    return fabs(newEnergy - oldEnergy) <= options.relativeVariation * fabs(newEnergy);
 }
 
 
 uint reachEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization) {
+    TELEMETRY_ADD(equilibrations, 1);
+    if (options.equilibrator != nullptr) {
+        const uint steps = options.equilibrator(lat, options, energy, magnetization);
+        TELEMETRY_ADD(equilibrationSteps, steps);
+        return steps;
+    }
+
     // Propriétés du réseau.
     double oldEnergy = energy;
     double deltaE = 0;
@@ -177,12 +355,95 @@ uint reachEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy,
 
         i++;
     }
+    TELEMETRY_ADD(equilibrationSteps, i);
     return i;
 }
 
-Properties thermalizeLattice(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint samplingPoints) {
-    assert(samplingPoints > 1);
+/// @brief Boucle commune aux détecteurs sur fenêtre glissante d'énergie.
+/// @param test Critère d'équilibre évalué sur la fenêtre
+static uint windowEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization, bool (*test)(const Stats::RingBuffer&)) {
+    Stats::RingBuffer window = Stats::ringBuffer();
+    const uint stride = std::max(1u, options.jumpSize / 32);
+    double deltaE = 0;
+    double deltaM = 0;
 
+    uint i = 0;
+    for (; i < options.epochThreshold; i++) {
+        if (i % stride == 0) {
+            Stats::push(window, energy);
+        }
+        if (i % options.jumpSize == 0 && window.count >= RING_CAPACITY / 2 && test(window)) {
+            std::cout << "[MC] Equilibrium state found.\n";
+            break;
+        }
+        options.mcIterator(lat, options, deltaE, deltaM);
+        energy += deltaE;
+        magnetization += deltaM;
+    }
+    return i;
+}
+
+static bool gewekeTest(const Stats::RingBuffer &window) {
+    return Stats::geweke(window) < 2;
+}
+
+static bool mserTest(const Stats::RingBuffer &window) {
+    return Stats::mserTruncation(window) <= window.count / 10;
+}
+
+uint gewekeEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization) {
+    return windowEquilibrium(lat, options, energy, magnetization, gewekeTest);
+}
+
+uint mserEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization) {
+    return windowEquilibrium(lat, options, energy, magnetization, mserTest);
+}
+
+uint hotColdEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization) {
+    // * La copie froide a sa propre table d'acceptation et un flux aléatoire disjoint de celui du réseau.
+    Ising::Lattice cold = Ising::copyLattice(lat);
+    RNG::jump(cold.rng);
+    Ising::uniformSpin(cold, UP);
+    Parameters coldOptions = options;
+    double coldEnergy = Ising::latticeEnergy(cold, options.J, options.h);
+    double coldMagnetization = Ising::magnetization(cold);
+
+    Stats::RingBuffer hot = Stats::ringBuffer();
+    Stats::RingBuffer frozen = Stats::ringBuffer();
+    const uint stride = std::max(1u, options.jumpSize / 32);
+    double deltaE = 0;
+    double deltaM = 0;
+
+    uint i = 0;
+    for (; i < options.epochThreshold; i++) {
+        if (i % stride == 0) {
+            Stats::push(hot, energy);
+            Stats::push(frozen, coldEnergy);
+        }
+        if (i % options.jumpSize == 0 && hot.count >= RING_CAPACITY / 2) {
+            double meanHot, varHot, meanCold, varCold;
+            const uint first = hot.count / 2;
+            Stats::moments(hot, first, hot.count, meanHot, varHot);
+            Stats::moments(frozen, first, frozen.count, meanCold, varCold);
+            const double n = hot.count - first;
+            if (fabs(meanHot - meanCold) <= 2 * std::sqrt((varHot + varCold) / n)) {
+                std::cout << "[MC] Equilibrium state found.\n";
+                break;
+            }
+        }
+        options.mcIterator(lat, options, deltaE, deltaM);
+        energy += deltaE;
+        magnetization += deltaM;
+        coldOptions.mcIterator(cold, coldOptions, deltaE, deltaM);
+        coldEnergy += deltaE;
+        coldMagnetization += deltaM;
+    }
+
+    Ising::freeLattice(cold);
+    return i;
+}
+
+Properties properties(uint samplingPoints) {
     Properties props = Properties(); 
     props.E = new double[samplingPoints];
     props.E_sq = new double[samplingPoints];
@@ -191,44 +452,142 @@ Properties thermalizeLattice(Ising::Lattice &lat, Parameters &options, double Ti
     props.M_abs = new double[samplingPoints];
     props.T = new double[samplingPoints];
     props.mcSteps = new double[samplingPoints];
-    
-    options.T = std::min(Ti, Tf);
-    double dT = fabs(Tf - Ti) / (samplingPoints - 1);
+    props.samples = new double[samplingPoints];
+    props.E_err = new double[samplingPoints]();
+    props.M_abs_err = new double[samplingPoints]();
+    props.tau = new double[samplingPoints]();
+    return props;
+}
+
+void freeProperties(Properties &props) {
+    double *all[] = { props.T, props.E, props.E_sq, props.M, props.M_sq, props.M_abs, props.mcSteps, props.samples, props.E_err, props.M_abs_err, props.tau };
+    for (double *column : all) {
+        delete[] column;
+    }
+    props = Properties();
+}
 
-    int equilibriumSteps;
-    int meanSteps;
+/// @brief Erreur relative sur une moyenne, infinie tant que la moyenne est nulle avec une erreur non nulle.
+static double relativeError(const Stats::Binning &bins) {
+    const double err = Stats::error(bins);
+    return err == 0 ? 0 : err / fabs(Stats::mean(bins));
+}
 
-    double energy = Ising::latticeEnergy(lat, options.J, options.h);
-    double magnetization = Ising::magnetization(lat);
+/// @brief Mesure tant que l'erreur visée n'est pas atteinte, une mesure toutes les ~τ itérations.
+static void sampleUntilError(Ising::Lattice &lat, Parameters &options, Properties &props, uint i, double &energy, double &magnetization) {
+    Stats::Binning energyBins = Stats::binning();
+    Stats::Binning magnetBins = Stats::binning();
     double deltaE = 0;
     double deltaM = 0;
 
-    for (uint i = 0; i < samplingPoints; i++)
-    {
-        std::cout << "[Thermalize] T = " << options.T << "\n";
-        equilibriumSteps = reachEquilibrium(lat, options, energy, magnetization);
-        meanSteps = options.dataRecordDuration * equilibriumSteps;
-        
-        props.E[i] = 0;
-        props.E_sq[i] = 0;
-        props.M[i] = 0;
-        props.M_sq[i] = 0;
-        props.M_abs[i] = 0;
-        props.T[i] = options.T;
-        props.mcSteps[i] = meanSteps;
+    // * Phase pilote de jumpSize itérations : τ est estimé sur la série complète, sans rien accumuler.
+    for (uint j = 0; j < options.jumpSize; j++) {
+        Stats::add(energyBins, energy);
+        Stats::add(magnetBins, fabs(magnetization));
+        options.mcIterator(lat, options, deltaE, deltaM);
+        energy += deltaE;
+        magnetization += deltaM;
+    }
+    const double tau = std::max(Stats::autocorrelationTime(energyBins), Stats::autocorrelationTime(magnetBins)) + 0.5;
+    const uint interval = std::max(1.0, std::ceil(tau));
+
+    // * Les erreurs sont estimées par blocs sur les mesures elles-mêmes : une corrélation résiduelle reste prise en compte.
+    energyBins = Stats::binning();
+    magnetBins = Stats::binning();
+    uint steps = 0;
+
+    while (steps < options.epochThreshold) {
+        props.E[i] += energy;
+        props.E_sq[i] += energy * energy;
+        props.M[i] += magnetization;
+        props.M_sq[i] += magnetization*magnetization;
+        props.M_abs[i] += fabs(magnetization);
+        props.samples[i]++;
+        Stats::add(energyBins, energy);
+        Stats::add(magnetBins, fabs(magnetization));
+        if (options.series != nullptr) {
+            options.series->push({ options.T, options.h, energy, magnetization });
+        }
 
-        for (int j = 0; j < meanSteps; j++)
-        {
-            props.E[i] += energy;
-            props.E_sq[i] += energy * energy;
-            props.M[i] += magnetization;
-            props.M_sq[i] += magnetization*magnetization;
-            props.M_abs[i] += fabs(magnetization);
+        if (props.samples[i] >= 2 * BINNING_MIN_BLOCKS && relativeError(energyBins) < options.targetError && relativeError(magnetBins) < options.targetError) {
+            break;
+        }
 
+        for (uint j = 0; j < interval; j++) {
             options.mcIterator(lat, options, deltaE, deltaM);
             energy += deltaE;
             magnetization += deltaM;
         }
+        steps += interval;
+    }
+
+    props.mcSteps[i] = steps * options.iterationSteps;
+    props.E_err[i] = Stats::error(energyBins);
+    props.M_abs_err[i] = Stats::error(magnetBins);
+    props.tau[i] = tau;
+}
+
+void samplePoint(Ising::Lattice &lat, Parameters &options, Properties &props, uint i, double &energy, double &magnetization) {
+    TELEMETRY_TIMER(timer);
+    TELEMETRY_SET(sites, lat.siteCount);
+    int equilibriumSteps = reachEquilibrium(lat, options, energy, magnetization);
+    double deltaE = 0;
+    double deltaM = 0;
+
+    props.E[i] = 0;
+    props.E_sq[i] = 0;
+    props.M[i] = 0;
+    props.M_sq[i] = 0;
+    props.M_abs[i] = 0;
+    props.samples[i] = 0;
+    props.E_err[i] = 0;
+    props.M_abs_err[i] = 0;
+    props.tau[i] = 0;
+
+    if (options.targetError > 0) {
+        sampleUntilError(lat, options, props, i, energy, magnetization);
+        TELEMETRY_ADD(iterations, equilibriumSteps + options.jumpSize + props.mcSteps[i] / options.iterationSteps);
+        return;
+    }
+
+    int meanSteps = options.dataRecordDuration * equilibriumSteps;
+    props.mcSteps[i] = meanSteps * options.iterationSteps;
+    props.samples[i] = meanSteps;
+    TELEMETRY_ADD(iterations, equilibriumSteps + meanSteps);
+
+    for (int j = 0; j < meanSteps; j++)
+    {
+        props.E[i] += energy;
+        props.E_sq[i] += energy * energy;
+        props.M[i] += magnetization;
+        props.M_sq[i] += magnetization*magnetization;
+        props.M_abs[i] += fabs(magnetization);
+        if (options.series != nullptr && j % options.seriesStride == 0) {
+            options.series->push({ options.T, options.h, energy, magnetization });
+        }
+
+        options.mcIterator(lat, options, deltaE, deltaM);
+        energy += deltaE;
+        magnetization += deltaM;
+    }
+}
+
+Properties thermalizeLattice(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint samplingPoints) {
+    assert(samplingPoints > 1);
+
+    Properties props = properties(samplingPoints);
+    
+    options.T = std::min(Ti, Tf);
+    double dT = fabs(Tf - Ti) / (samplingPoints - 1);
+
+    double energy = Ising::latticeEnergy(lat, options.J, options.h);
+    double magnetization = Ising::magnetization(lat);
+
+    for (uint i = 0; i < samplingPoints; i++)
+    {
+        std::cout << "[Thermalize] T = " << options.T << "\n";
+        props.T[i] = options.T;
+        samplePoint(lat, options, props, i, energy, magnetization);
         
         options.T += dT;
     }
@@ -238,59 +597,76 @@ Properties thermalizeLattice(Ising::Lattice &lat, Parameters &options, double Ti
 Properties magnetizeLattice(Ising::Lattice &lat, Parameters &options, double hi, double hf, uint samplingPoints) {
     assert(samplingPoints > 1);
 
-    Properties props = Properties(); 
-    props.E = new double[samplingPoints];
-    props.E_sq = new double[samplingPoints];
-    props.M = new double[samplingPoints];
-    props.M_sq = new double[samplingPoints];
-    props.M_abs = new double[samplingPoints];
-    props.T = new double[samplingPoints];
-    props.mcSteps = new double[samplingPoints];
+    Properties props = properties(samplingPoints);
     
     options.h = std::min(hi, hf);
     double dh = fabs(hf - hi) / (samplingPoints - 1);
 
-    int equilibriumSteps;
-    int meanSteps;
-
     double energy = Ising::latticeEnergy(lat, options.J, options.h);
     double magnetization = Ising::magnetization(lat);
-    double deltaE = 0;
-    double deltaM = 0;
 
     for (uint i = 0; i < samplingPoints; i++)
     {
         std::cout << "[Magnetize] h = " << options.h << "\n";
-        equilibriumSteps = reachEquilibrium(lat, options, energy, magnetization);
-        meanSteps = options.dataRecordDuration * equilibriumSteps;
-        
         props.T[i] = options.h;
-        props.E[i] = 0;
-        props.E_sq[i] = 0;
-        props.M[i] = 0;
-        props.M_sq[i] = 0;
-        props.M_abs[i] = 0;
-        props.mcSteps[i] = meanSteps;
-
-        for (int j = 0; j < meanSteps; j++)
-        {
-            props.E[i] += energy;
-            props.E_sq[i] += energy * energy;
-            props.M[i] += magnetization;
-            props.M_sq[i] += magnetization*magnetization;
-            props.M_abs[i] += fabs(magnetization);
-            
-            options.mcIterator(lat, options, deltaE, deltaM);
-            energy += deltaE;
-            magnetization += deltaM;
-        }
+        samplePoint(lat, options, props, i, energy, magnetization);
 
-        // Etape de normalisation
-        
         options.h += dh;
         energy -= dh * magnetization; // L'énergie totale est modifié en changeant le champ magnétique
     }
     return props;
 }
 
-}
\ No newline at end of file
+/// @brief Balayage parallèle commun aux balayages en température et en champ.
+/// @param variable Paramètre balayé (&Parameters::T ou &Parameters::h)
+/// @param label Préfixe des messages de suivi
+static Properties sweepParallel(Ising::Lattice &lat, Parameters &options, double Xi, double Xf, uint samplingPoints, uint chainLength, double Parameters::*variable, const char *label) {
+    assert(samplingPoints > 1 && chainLength > 0);
+
+    Properties props = properties(samplingPoints);
+    const double start = std::min(Xi, Xf);
+    const double step = fabs(Xf - Xi) / (samplingPoints - 1);
+    const uint chains = (samplingPoints + chainLength - 1) / chainLength;
+
+    // ! Series::Writer n'accepte qu'un seul producteur : les chaînes parallèles n'alimentent pas la série.
+    if (options.series != nullptr) {
+        std::cerr << "[Parallel] options.series is ignored by parallel sweeps (single-producer writer)\n";
+    }
+
+    Parallel::forEach(chains, options.threads, [&](uint chain, uint worker) {
+        Ising::Lattice copy = Ising::copyLattice(lat);
+        Ising::seed(copy, options.seed, chain + 1);
+
+        // * Chaque chaîne a ses propres paramètres (table d'acceptation comprise), sans parallélisme imbriqué.
+        Parameters local = options;
+        local.threads = 1;
+        local.series = nullptr;
+
+        const uint first = chain * chainLength;
+        const uint last = std::min(samplingPoints, first + chainLength);
+        for (uint i = first; i < last; i++) {
+            local.*variable = start + i * step;
+            double energy = Ising::latticeEnergy(copy, local.J, local.h);
+            double magnetization = Ising::magnetization(copy);
+
+            std::cout << (std::string(label) + " " + std::to_string(local.*variable) + " (chain " + std::to_string(chain) + ")\n");
+            props.T[i] = local.*variable;
+            samplePoint(copy, local, props, i, energy, magnetization);
+        }
+
+        Ising::freeLattice(copy);
+    });
+
+    options.*variable = start + samplingPoints * step;
+    return props;
+}
+
+Properties thermalizeLatticeParallel(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint samplingPoints, uint chainLength) {
+    return sweepParallel(lat, options, Ti, Tf, samplingPoints, chainLength, &Parameters::T, "[Thermalize] T =");
+}
+
+Properties magnetizeLatticeParallel(Ising::Lattice &lat, Parameters &options, double hi, double hf, uint samplingPoints, uint chainLength) {
+    return sweepParallel(lat, options, hi, hf, samplingPoints, chainLength, &Parameters::h, "[Magnetize] h =");
+}
+
+}
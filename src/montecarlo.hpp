@@ -1,13 +1,42 @@
 #pragma once
 
 #include "ising.hpp"
-#include <stack>
-#include <map>
+#include "stats.hpp"
+#include "series.hpp"
 #include <cmath>
 #include <iostream>
 
 namespace MC {
 
+/// @brief Nombre d'entrées de la table d'acceptation : champ local (de -MAX_NEIGHBORS à MAX_NEIGHBORS, pour toutes
+/// les dimensions) et sens du spin.
+#define TABLE_SIZE (2 * Ising::MAX_NEIGHBORS + 2)
+
+/// @brief Probabilités d'acceptation d'un spin-flip précalculées pour T, J et h donnés.
+/// L'entrée d'un site est indexée par tableIndex(champ local, spin).
+struct AcceptanceTable {
+    double T;
+    double J;
+    double h;
+    double kB;
+
+    double probability[TABLE_SIZE];
+    double deltaE[TABLE_SIZE];
+    // Probabilité de retournement du bain thermique (Glauber) : 1 / (1 + exp(ΔE/kT))
+    double heatBath[TABLE_SIZE];
+
+    // Probabilité d'ajout d'un voisin parallèle à un cluster : 1 - exp(-2J/kT)
+    double bondProbability;
+};
+
+/// @brief Indice dans la table d'acceptation d'un site de champ local et de spin donnés.
+/// @param field Somme des spins voisins
+/// @param spin Valeur du spin
+/// @return Indice dans AcceptanceTable
+inline int tableIndex(const int field, const int spin) {
+    return field + Ising::MAX_NEIGHBORS + (spin > 0);
+}
+
 struct Parameters
 {
     uint epochThreshold;
@@ -16,13 +45,33 @@ struct Parameters
     double relativeVariation;
 
     void (*mcIterator)(Ising::Lattice&, Parameters&, double&, double&);
+    // Détecteur d'équilibre appelé par reachEquilibrium (nullptr : comparaison de deux énergies à jumpSize d'écart)
+    uint (*equilibrator)(Ising::Lattice&, Parameters&, double&, double&);
 
     double J;
     double h;
     double T;
     double kB;
+
+    uint64_t seed;
+    uint threads;
+
+    // Erreur relative visée sur <E> et <|M|> de chaque point (0 : durée de mesure dataRecordDuration * étapes d'équilibre)
+    double targetError;
+
+    // Tentatives de Metropolis équivalentes à une itération, pour Properties::mcSteps (1 par défaut),
+    // et durée simulée par une itération de nFoldIteration
+    double iterationSteps;
+
+    // Série temporelle des mesures (nullptr : aucune), alimentée toutes les seriesStride itérations de mesure,
+    // ou à chaque mesure espacée si targetError > 0
+    Series::Writer *series;
+    uint seriesStride;
+
+    AcceptanceTable table;
 };
 
+/// @brief Construit les paramètres de simulation (graine nulle, un seul thread, détecteur d'équilibre historique par défaut).
 Parameters parameters(uint epochTreshold, uint jumpSize, double dataRecordDuration, double relativeVariation, void (*mcIterator)(Ising::Lattice&, Parameters&, double&, double&), double T, double J, double h, double kB);
 
 struct Properties {
@@ -32,12 +81,20 @@ struct Properties {
     double *M;
     double *M_sq;
     double *M_abs;
+    // Nombre d'étapes de mesure, en tentatives de Metropolis équivalentes (itérations * iterationSteps)
     double *mcSteps;
-};
 
-typedef std::pair<int, int> Site;
+    // Nombre de mesures sommées dans E, E_sq, M, M_sq et M_abs
+    double *samples;
+    // Erreurs sur les moyennes de E et |M| et temps d'autocorrélation intégré en itérations (0 si non estimés)
+    double *E_err;
+    double *M_abs_err;
+    double *tau;
+};
 
-Site makeSite(Ising::Lattice &lat, int x, int y);
+/// @brief Reconstruit la table d'acceptation si T, J, h ou kB ont changé depuis le dernier appel.
+/// @param options Paramètres de simulation
+void updateAcceptance(Parameters &options);
 
 /// @brief Effectue une seule itération de l'algorithme de Metropolis sur le réseau
 /// @param lat Réseau de spin
@@ -46,40 +103,55 @@ Site makeSite(Ising::Lattice &lat, int x, int y);
 /// @param deltaM Variable où stocker la différence de magnetisation du mouvement Monte-Carlo
 void metropolisIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
 
-/// @brief 
-/// @param lat 
-/// @param options 
-/// @param stack 
-/// @param rejectedSite 
-/// @param neighbor_x 
-/// @param neighbor_y 
-/// @param spin0 
-/// @param clusterSize 
-/// @param clusterSpin 
-/// @param clusterNeighbor 
-void tryNeighbor(Ising::Lattice &lat, Parameters &options, std::stack<Site> &stack, std::map<Site, int> &cluster, int neighbor_x, int neighbor_y, int spin0);
-
 /// @brief Effectue une seule itération de l'algorithme de Wolff sur le réseau.
 /// Cet algorithme ne nécessite pas de l'itérer un grand nombre de fois, pour un réseau
 /// de taille 256x256, une vingtaine d'itérations suffit à atteindre un équilibre.
 /// Stack = pas de fonction récursive sujette à exploser le call stack (8Mb sur Fedora par défaut).
-/// Un stack offre autant d'appels que de RAM disponible.
-// ! Cet algorithme n'est pas pertinent pour h != 0, metropolis convergera très rapidement vers l'état d'équilibre de toute manière
-// ! Tenir compte de h implique de rajouter une seconde hashmap pour suivre les noeuds du cluster sans les retourner, le retournement du cluster
-// ! étant conditionné par ΔS = 2h * spin_cluster, une fois le cluster construit ... Complexifie inutilement l'algorithme quand Metropolis fonctionne pour ce cas.
+/// La pile et le marquage des sites visités (par époque, sans remise à zéro) sont alloués au premier appel
+/// (Ising::allocateWorkspace) puis réutilisés : une itération n'alloue rien. Les spins sont retournés au fur et à mesure
+/// de la croissance du cluster, ce qui donne directement la variation d'énergie.
+/// Pour h != 0, le cluster est construit comme pour h = 0 (les liaisons ne dépendent que de J) puis gardé avec la
+/// probabilité min(1, exp(-2h * spin_cluster * |C| / kT)) ; s'il est rejeté, ses sites, mémorisés dans l'espace de
+/// travail, sont remis en place. Les variations d'énergie et de magnétisation restent exactes.
+/// La taille du cluster construit, même rejeté, est gardée dans lat.clusterSize.
+// ! Les clusters sont de plus en plus rejetés quand h|C| dépasse kT : loin de Tc en champ fort, préférer metropolis ou nFoldIteration.
 /// @param lat Réseau de spin
 /// @param options Paramètres de simulation 
 void wolffIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
 
+/// @brief Accepte ou non le retournement d'un cluster de Wolff déjà retourné, en présence du champ h, et le défait sinon.
+/// Les liaisons ne dépendant que de J, le bilan détaillé est assuré par l'acceptation min(1, exp(-2h spin0 |C| / kT)).
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param spin0 Spin des sites du cluster avant retournement
+/// @param cluster Sites du cluster
+/// @param clusterSize Nombre de sites du cluster
+/// @return true si le cluster reste retourné
+bool acceptCluster(Ising::Lattice &lat, Parameters &options, const int spin0, const uint *cluster, const uint clusterSize);
+
+/// @brief Effectue un balayage de l'algorithme de Swendsen-Wang : des liaisons sont placées entre voisins parallèles
+/// sur tout le réseau avec la probabilité 1 - exp(-2J/kT), les clusters sont étiquetés par union-find (compression
+/// de chemin), puis chaque cluster est retourné avec probabilité 1/2.
+/// L'étiquetage est réparti en bandes de lignes sur options.threads threads, les liaisons entre bandes étant
+/// ajoutées ensuite. Le résultat dépend de la graine et du nombre de threads.
+/// Après l'appel, lat.clusterMoment contient l'estimateur amélioré Σ|C|² / N.
+// ! Uniquement pour h = 0.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void swendsenWangIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+
 /// @brief Vérifie si la variation relative d'énergie est sous un seuil donné qu'on considère comme équilibre.
 /// @param lat Réseau de spin
 /// @param options Paramètres de simulation
 /// @param oldEnergy Ancienne énergie
 /// @param newEnergy Nouvelle énergie
-/// @return 
-int atEquilibrium(Ising::Lattice &lat, Parameters &options, int oldEnergy, int newEnergy);
+/// @return 1 si |newEnergy - oldEnergy| <= relativeVariation * |newEnergy| (vrai aussi pour deux énergies nulles)
+int atEquilibrium(Ising::Lattice &lat, Parameters &options, double oldEnergy, double newEnergy);
 
 /// @brief Itère un des deux algorithmes Monte-Carlo pour emmener le réseau à l'équilibre dans les conditions données.
+/// Délègue à options.equilibrator s'il est défini.
 /// @param lat Réseau de spin
 /// @param options Paramètres de simulation
 /// @param energy Energie du réseau (doit être initialisée à la valeur actuelle préalablement)
@@ -87,6 +159,45 @@ int atEquilibrium(Ising::Lattice &lat, Parameters &options, int oldEnergy, int n
 /// @return Nombre d'itérations nécessaire pour atteindre l'équilibre.
 uint reachEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization);
 
+// Détecteurs d'équilibre à utiliser comme options.equilibrator. L'énergie est relevée toutes les jumpSize / 32 itérations
+// dans une fenêtre glissante de RING_CAPACITY valeurs, et le test est évalué toutes les jumpSize itérations une fois
+// la fenêtre à moitié remplie. Tous s'arrêtent après epochThreshold itérations au plus.
+
+/// @brief Equilibre quand le score de Geweke de la fenêtre (début contre seconde moitié) est sous 2.
+uint gewekeEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization);
+
+/// @brief Equilibre quand le point de troncature MSER de la fenêtre tombe dans son premier dixième :
+/// le transitoire est sorti de la fenêtre.
+uint mserEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization);
+
+/// @brief Equilibre quand une copie du réseau partie de l'état ordonné (tous les spins UP, flux aléatoire sauté)
+/// et le réseau lui-même ont des énergies moyennes compatibles (à 2 écarts-types) sur la seconde moitié de leurs fenêtres.
+/// Adapté à un départ désordonné à basse température, où le réseau peut rester bloqué dans un état métastable.
+// ! Réseau non compacté uniquement (uniformSpin ne met pas à jour lat.bits).
+uint hotColdEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy, double &magnetization);
+
+/// @brief Alloue les tableaux de propriétés pour un nombre de points donné.
+/// @param samplingPoints Nombre de points
+/// @return Propriétés allouées
+Properties properties(uint samplingPoints);
+
+/// @brief Libère les tableaux alloués par properties.
+/// @param props Propriétés à libérer
+void freeProperties(Properties &props);
+
+/// @brief Amène le réseau à l'équilibre dans les conditions courantes puis accumule les grandeurs moyennes du point i.
+/// Si options.targetError est nul, une mesure est prise à chaque itération pendant dataRecordDuration fois le nombre
+/// d'itérations d'équilibrage. Sinon, le temps d'autocorrélation intégré τ de E et |M| est estimé sur jumpSize
+/// itérations, une mesure est prise toutes les ~τ itérations, et le point s'arrête dès que les erreurs relatives
+/// (méthode des blocs) sur <E> et <|M|> sont sous options.targetError, ou après epochThreshold itérations de mesure.
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param props Propriétés à remplir (toutes les grandeurs du point i sauf T)
+/// @param i Indice du point
+/// @param energy Energie du réseau (tenue à jour)
+/// @param magnetization Magnetisation du réseau (tenue à jour)
+void samplePoint(Ising::Lattice &lat, Parameters &options, Properties &props, uint i, double &energy, double &magnetization);
+
 /// @brief Fait varier la température progressivement pour obtenir l'évolution des grandeurs moyennes selon la température
 /// @param lat Réseau de spin
 /// @param options Paramètres de simulation
@@ -95,5 +206,34 @@ uint reachEquilibrium(Ising::Lattice &lat, Parameters &options, double &energy,
 /// @param samplingPoints Nombre de points à calculer
 Properties thermalizeLattice(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint samplingPoints);
 
+/// @brief Fait varier le champ magnétique progressivement pour obtenir l'évolution des grandeurs moyennes selon h
+/// @param lat Réseau de spin
+/// @param options Paramètres de simulation
+/// @param hi Champ de départ
+/// @param hf Champ de fin
+/// @param samplingPoints Nombre de points à calculer
 Properties magnetizeLattice(Ising::Lattice &lat, Parameters &options, double hi, double hf, uint samplingPoints);
+
+/// @brief Version parallèle de thermalizeLattice : les points sont répartis sur options.threads threads (vol de travail).
+/// Les points sont groupés en chaînes de chainLength points consécutifs : une chaîne part d'une copie du réseau lat,
+/// avec son propre flux aléatoire (options.seed, numéro de chaîne + 1), et chaque point y part de l'état équilibré
+/// du point précédent. chainLength = 1 rend tous les points indépendants, chainLength = samplingPoints
+/// redonne la chaîne séquentielle de thermalizeLattice. lat n'est pas modifié.
+/// options.series est ignoré (avec un message) : Series::Writer n'accepte qu'un seul producteur.
+/// @param lat Réseau de spin de départ
+/// @param options Paramètres de simulation
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param samplingPoints Nombre de points à calculer
+/// @param chainLength Nombre de points par chaîne de démarrage à chaud
+Properties thermalizeLatticeParallel(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint samplingPoints, uint chainLength);
+
+/// @brief Version parallèle de magnetizeLattice, voir thermalizeLatticeParallel.
+/// @param lat Réseau de spin de départ
+/// @param options Paramètres de simulation
+/// @param hi Champ de départ
+/// @param hf Champ de fin
+/// @param samplingPoints Nombre de points à calculer
+/// @param chainLength Nombre de points par chaîne de démarrage à chaud
+Properties magnetizeLatticeParallel(Ising::Lattice &lat, Parameters &options, double hi, double hf, uint samplingPoints, uint chainLength);
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "multispin.hpp"
+
+namespace MC {
+
+/// @brief Tire un mot de 64 bits indépendants valant chacun 1 avec une probabilité threshold / 2^32.
+/// Chaque bit compare un uniforme à la probabilité chiffre binaire par chiffre binaire, en partant du poids fort :
+/// le premier chiffre différent décide. Il suffit en moyenne de quelques mots aléatoires pour décider les 64 bits.
+static uint64_t bernoulliWord(RNG::Generator &generator, const uint32_t threshold) {
+    uint64_t result = 0;
+    uint64_t undecided = ~0ULL;
+
+    for (int i = 31; i >= 0 && undecided; i--) {
+        const uint64_t r = RNG::next(generator);
+        if ((threshold >> i) & 1) {
+            result |= undecided & ~r;
+            undecided &= r;
+        }
+        else {
+            undecided &= ~r;
+        }
+    }
+    return result;
+}
+
+void multiSpinIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(lat.bits != nullptr && lat.sizeY % 2 == 0);
+    assert(options.h == 0 && options.J >= 0);
+    updateAcceptance(options);
+
+    // * Avec h = 0, ΔE = 2J(4 - 2a) où a est le nombre de voisins antiparallèles :
+    // * a >= 2 est toujours accepté, a = 1 avec p = exp(-4J/kT), a = 0 avec p².
+    const double p = options.table.probability[tableIndex(2, UP)];
+    const uint32_t threshold = (uint32_t)std::min(p * 4294967296.0, 4294967295.0);
+    RNG::Generator &generator = lat.rng;
+
+    const uint W = Ising::wordsPerRow(lat);
+    const uint sizeY = lat.sizeY;
+
+    int64_t flipped = 0;
+    int64_t flippedUp = 0;
+    int64_t flippedAntiparallel = 0;
+
+    for (uint color = 0; color < 2; color++) {
+        for (uint y = 0; y < sizeY; y++) {
+            uint64_t *row = lat.bits + y * W;
+            const uint64_t *above = lat.bits + ((y + sizeY - 1) % sizeY) * W;
+            const uint64_t *below = lat.bits + ((y + 1) % sizeY) * W;
+            // * Bits des sites de la couleur courante : x = 64w + b a la parité de b.
+            const uint64_t mask = ((y + color) & 1) ? 0xAAAAAAAAAAAAAAAAULL : 0x5555555555555555ULL;
+
+            for (uint w = 0; w < W; w++) {
+                const uint64_t s = row[w];
+                const uint64_t right = (s >> 1) | (row[w + 1 == W ? 0 : w + 1] << 63);
+                const uint64_t left = (s << 1) | (row[w == 0 ? W - 1 : w - 1] >> 63);
+
+                // * Voisins antiparallèles, puis somme a = s0 + 2 s1 + 4 s2 par additionneur bit à bit.
+                const uint64_t x1 = s ^ above[w];
+                const uint64_t x2 = s ^ below[w];
+                const uint64_t x3 = s ^ right;
+                const uint64_t x4 = s ^ left;
+
+                const uint64_t t1 = x1 ^ x2;
+                const uint64_t t2 = x3 ^ x4;
+                const uint64_t c1 = x1 & x2;
+                const uint64_t c2 = x3 & x4;
+                const uint64_t c3 = t1 & t2;
+                const uint64_t s0 = t1 ^ t2;
+                const uint64_t s1 = c1 ^ c2 ^ c3;
+                const uint64_t s2 = c1 & c2;
+
+                uint64_t accept = mask & (s1 | s2);
+                const uint64_t candidates = mask & ~(s1 | s2);
+                if (candidates) {
+                    uint64_t trial = candidates & bernoulliWord(generator, threshold);
+                    if (trial & ~s0) {
+                        trial &= s0 | bernoulliWord(generator, threshold);
+                    }
+                    accept |= trial;
+                }
+
+                row[w] = s ^ accept;
+
+                flipped += __builtin_popcountll(accept);
+                flippedUp += __builtin_popcountll(accept & s);
+                flippedAntiparallel += __builtin_popcountll(accept & s0) + 2 * __builtin_popcountll(accept & s1) + 4 * __builtin_popcountll(accept & s2);
+            }
+        }
+    }
+
+    TELEMETRY_ADD(attempts, lat.siteCount);
+    TELEMETRY_ADD(accepted, flipped);
+    deltaE = options.J * (8 * flipped - 4 * flippedAntiparallel);
+    deltaM = 2 * flipped - 4 * flippedUp;
+}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Moteur de Metropolis à codage multi-spin : le réseau compacté (Ising::packLattice) contient 64 spins par mot,
+// le nombre de voisins antiparallèles et l'acceptation des 64 sites d'un mot sont évalués par opérations bit à bit.
+
+namespace MC {
+
+/// @brief Effectue un balayage complet en damier sur un réseau compacté.
+/// Le réseau doit avoir été compacté par Ising::packLattice (sizeX multiple de 64, sizeY pair).
+// ! Seul le cas h = 0 et J >= 0 est traité : l'acceptation ne dépend alors que du nombre de voisins antiparallèles.
+/// @param lat Réseau de spin compacté
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie du balayage
+/// @param deltaM Variable où stocker la différence de magnetisation du balayage
+void multiSpinIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
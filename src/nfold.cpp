@@ -0,0 +1,159 @@
+#include "nfold.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MC {
+
+/// @brief Voisin k d'un site, par la table de voisinage si le réseau en a une, par les pas sinon.
+static inline uint neighborOf(const Ising::Lattice &lat, const uint site, const uint k) {
+    return lat.neighbor != nullptr ? Ising::neighbor(lat, site, k) : Ising::hypercubeNeighbor(lat, site, k);
+}
+
+/// @brief Classe d'un site : son indice dans la table d'acceptation.
+static inline uint classOf(const Ising::Lattice &lat, const uint site) {
+    int field = 0;
+    for (uint k = 0; k < 2 * lat.dimension; k++) {
+        field += lat.spin[neighborOf(lat, site, k)];
+    }
+    return tableIndex(field, lat.spin[site]);
+}
+
+/// @brief Classe d'un site d'après sa place dans order.
+static inline uint currentClass(const Ising::Lattice &lat, const uint site) {
+    uint c = 0;
+    while (lat.classStart[c + 1] <= lat.position[site]) {
+        c++;
+    }
+    return c;
+}
+
+/// @brief Echange les places de deux sites dans order.
+static inline void swapPlaces(Ising::Lattice &lat, const uint a, const uint b) {
+    const uint placeA = lat.position[a];
+    const uint placeB = lat.position[b];
+    lat.order[placeA] = b;
+    lat.order[placeB] = a;
+    lat.position[a] = placeB;
+    lat.position[b] = placeA;
+}
+
+/// @brief Déplace un site de la classe from à la classe to, en décalant d'une place la frontière de chaque classe
+/// intermédiaire : O(|to - from|) échanges.
+static void moveSite(Ising::Lattice &lat, const uint site, uint from, const uint to) {
+    uint *start = lat.classStart;
+    // * Vers le haut : le site prend la dernière place de sa classe, qui devient la première de la suivante.
+    for (; from < to; from++) {
+        swapPlaces(lat, site, lat.order[start[from + 1] - 1]);
+        start[from + 1]--;
+    }
+    // * Vers le bas : le site prend la première place de sa classe, qui devient la dernière de la précédente.
+    for (; from > to; from--) {
+        swapPlaces(lat, site, lat.order[start[from]]);
+        start[from]++;
+    }
+}
+
+/// @brief Range tous les sites par classe (tri par dénombrement).
+static void buildClasses(Ising::Lattice &lat) {
+    lat.order = (uint*)malloc(sizeof(uint) * lat.siteCount);
+    lat.position = (uint*)malloc(sizeof(uint) * lat.siteCount);
+
+    uint *start = lat.classStart;
+    std::fill(start, start + TABLE_SIZE + 1, 0);
+    for (uint i = 0; i < lat.siteCount; i++) {
+        start[classOf(lat, i) + 1]++;
+    }
+    for (uint c = 0; c < TABLE_SIZE; c++) {
+        start[c + 1] += start[c];
+    }
+
+    uint next[TABLE_SIZE];
+    std::copy(start, start + TABLE_SIZE, next);
+    for (uint i = 0; i < lat.siteCount; i++) {
+        const uint place = next[classOf(lat, i)]++;
+        lat.order[place] = i;
+        lat.position[i] = place;
+    }
+    lat.rate = -1;
+}
+
+/// @brief Probabilité qu'une tentative de Metropolis (site uniforme) aboutisse à un retournement.
+static double flipRate(const Ising::Lattice &lat, const AcceptanceTable &table) {
+    double weight = 0;
+    for (uint c = 0; c < TABLE_SIZE; c++) {
+        weight += (lat.classStart[c + 1] - lat.classStart[c]) * table.probability[c];
+    }
+    return weight / lat.siteCount;
+}
+
+/// @brief Nombre de tentatives jusqu'au prochain retournement inclus, de loi géométrique de paramètre rate (infini si nul).
+static double waitingTime(RNG::Generator &rng, const double rate) {
+    if (rate >= 1) {
+        return 1;
+    }
+    if (rate <= 0) {
+        return INFINITY;
+    }
+    return 1 + std::floor(std::log(1 - RNG::uniform(rng)) / std::log1p(-rate));
+}
+
+void nFoldIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM) {
+    assert(lat.bits == nullptr);
+    updateAcceptance(options);
+    if (lat.order == nullptr) {
+        buildClasses(lat);
+    }
+    const AcceptanceTable &table = options.table;
+
+    deltaE = 0;
+    deltaM = 0;
+
+    // * La loi géométrique est sans mémoire : si T, J ou h ont changé, l'attente restante est simplement retirée.
+    double rate = flipRate(lat, table);
+    if (rate != lat.rate) {
+        lat.rate = rate;
+        lat.waiting = waitingTime(lat.rng, rate);
+    }
+
+    double budget = options.iterationSteps;
+    while (lat.waiting <= budget) {
+        budget -= lat.waiting;
+
+        // * Classe choisie proportionnellement à son poids, puis site uniforme dans la classe.
+        double target = RNG::uniform(lat.rng) * rate * lat.siteCount;
+        uint c = 0;
+        for (; c < TABLE_SIZE - 1; c++) {
+            target -= (lat.classStart[c + 1] - lat.classStart[c]) * table.probability[c];
+            if (target < 0) {
+                break;
+            }
+        }
+        // * Une erreur d'arrondi peut mener au-delà de la dernière classe non vide : on revient à celle-ci.
+        while (lat.classStart[c + 1] == lat.classStart[c] || table.probability[c] == 0) {
+            c--;
+        }
+        const uint count = lat.classStart[c + 1] - lat.classStart[c];
+        const uint site = lat.order[lat.classStart[c] + RNG::bounded(lat.rng, count)];
+
+        const int spin = lat.spin[site];
+        deltaE += table.deltaE[c];
+        deltaM -= 2 * spin;
+        lat.spin[site] = -spin;
+        TELEMETRY_ADD(accepted, 1);
+
+        // * Seuls le site et ses voisins changent de classe.
+        moveSite(lat, site, c, classOf(lat, site));
+        for (uint k = 0; k < 2 * lat.dimension; k++) {
+            const uint next = neighborOf(lat, site, k);
+            moveSite(lat, next, currentClass(lat, next), classOf(lat, next));
+        }
+
+        rate = flipRate(lat, table);
+        lat.rate = rate;
+        lat.waiting = waitingTime(lat.rng, rate);
+    }
+    lat.waiting -= budget;
+    TELEMETRY_ADD(attempts, options.iterationSteps);
+}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Algorithme n-fold way (Bortz, Kalos et Lebowitz), sans rejet : chaque site est rangé dans la classe de son couple
+// (champ local, spin), c'est-à-dire de sa probabilité d'acceptation de Metropolis. Un retournement choisit une classe
+// proportionnellement à son poids (au plus TABLE_SIZE classes) puis un site uniforme de la classe, et l'horloge avance
+// du nombre de tentatives de Metropolis qui auraient été rejetées entre-temps (loi géométrique).
+// La dynamique est exactement celle de metropolisIteration, mesurée en tentatives : à basse température ou en champ
+// fort, où presque toutes les tentatives sont rejetées, une itération couvrant iterationSteps tentatives coûte O(1).
+
+namespace MC {
+
+/// @brief Fait avancer l'horloge de options.iterationSteps tentatives de Metropolis, en effectuant tous les
+/// retournements qui tombent dans l'intervalle (aucun si le prochain est plus loin). Avec iterationSteps = 1,
+/// une itération équivaut en loi à une itération de metropolisIteration ; avec iterationSteps = siteCount, à un
+/// balayage, et epochThreshold et jumpSize s'expriment en balayages. Properties::mcSteps compte les tentatives.
+/// Les classes sont construites au premier appel (O(N)) puis tenues à jour à chaque retournement.
+// ! Les spins ne doivent pas être modifiés par une autre itération entre deux appels, sauf par uniformSpin ou randomSpin.
+/// @param lat Réseau de spin (1D, 2D ou hypercubique, non compacté)
+/// @param options Paramètres de simulation
+/// @param deltaE Variable où stocker la différence d'énergie de l'itération
+/// @param deltaM Variable où stocker la différence de magnetisation de l'itération
+void nFoldIteration(Ising::Lattice &lat, Parameters &options, double &deltaE, double &deltaM);
+}
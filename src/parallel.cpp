@@ -0,0 +1,168 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <pthread.h>
+#include <sched.h>
+
+namespace Parallel {
+
+/// @brief File de tâches d'un thread : il la consomme par l'avant, les voleurs se servent par l'arrière.
+struct TaskQueue {
+    std::mutex mutex;
+    std::deque<uint> tasks;
+};
+
+/// @brief Retire une tâche de la file d'un thread, par l'avant (propriétaire) ou par l'arrière (voleur).
+static bool popTask(TaskQueue &queue, uint &task, bool steal) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    if (steal) {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+    }
+    else {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+    }
+    return true;
+}
+
+void forEach(uint count, uint threads, const std::function<void(uint, uint)> &task) {
+    threads = std::max(1u, std::min(threads, count));
+    if (threads == 1) {
+        for (uint i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    // * Blocs contigus : les tâches voisines (points de balayage voisins) restent sur le même thread.
+    std::vector<TaskQueue> queues(threads);
+    for (uint i = 0; i < count; i++) {
+        queues[(uint64_t)i * threads / count].tasks.push_back(i);
+    }
+
+    auto work = [&](uint worker) {
+        uint current;
+        while (true) {
+            if (popTask(queues[worker], current, false)) {
+                task(current, worker);
+                continue;
+            }
+
+            // * Aucune tâche n'est ajoutée en cours d'exécution : si toutes les files sont vides, tout est distribué.
+            bool stolen = false;
+            for (uint k = 1; k < threads && !stolen; k++) {
+                stolen = popTask(queues[(worker + k) % threads], current, true);
+            }
+            if (!stolen) {
+                return;
+            }
+            task(current, worker);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (uint w = 1; w < threads; w++) {
+        workers.emplace_back(work, w);
+    }
+    work(0);
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+uint hardwareThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void pinThread(uint core) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % hardwareThreads(), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+Barrier::Barrier(uint count) : count(count), waiting(0), generation(0) {}
+
+void Barrier::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const uint arrival = generation;
+    if (++waiting == count) {
+        waiting = 0;
+        generation++;
+        condition.notify_all();
+        return;
+    }
+    condition.wait(lock, [&] { return generation != arrival; });
+}
+
+Team::Team(uint threads) : job(nullptr), generation(0), pending(0), stopping(false) {
+    for (uint w = 1; w < std::max(1u, threads); w++) {
+        workers.emplace_back(&Team::loop, this, w);
+    }
+}
+
+Team::~Team() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+uint Team::size() const {
+    return workers.size() + 1;
+}
+
+void Team::run(const std::function<void(uint)> &task) {
+    std::lock_guard<std::mutex> runLock(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        pending = workers.size();
+        generation++;
+    }
+    start.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+    job = nullptr;
+}
+
+void Team::loop(uint worker) {
+    pinThread(worker);
+    uint seen = 0;
+
+    while (true) {
+        const std::function<void(uint)> *task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = job;
+        }
+
+        (*task)(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            done.notify_one();
+        }
+    }
+}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+// Outils de parallélisation en mémoire partagée : les tâches sont réparties en blocs contigus sur les threads,
+// un thread sans travail vole les tâches restantes en fin de file d'un autre thread.
+
+namespace Parallel {
+
+/// @brief Exécute task(i, worker) pour tout i de [0, count) sur au plus threads threads, avec vol de travail.
+/// @param count Nombre de tâches
+/// @param threads Nombre de threads (1 : exécution séquentielle dans le thread appelant)
+/// @param task Tâche à exécuter, reçoit son indice et le numéro du thread qui l'exécute
+void forEach(uint count, uint threads, const std::function<void(uint, uint)> &task);
+
+/// @brief Nombre de threads matériels disponibles (au moins 1).
+uint hardwareThreads();
+
+/// @brief Barrière de synchronisation réutilisable entre un nombre fixe de threads.
+class Barrier {
+public:
+    explicit Barrier(uint count);
+
+    /// @brief Bloque jusqu'à ce que les count threads aient atteint la barrière.
+    void wait();
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint count;
+    uint waiting;
+    uint generation;
+};
+
+/// @brief Equipe de threads persistants, chacun fixé sur un coeur (worker % hardwareThreads()).
+/// Le thread appelant de run() joue le rôle du worker 0. Les appels concurrents à run() sont sérialisés.
+class Team {
+public:
+    explicit Team(uint threads);
+    ~Team();
+
+    /// @brief Nombre de workers, thread appelant compris.
+    uint size() const;
+
+    /// @brief Exécute job(worker) sur chaque worker et attend la fin de tous.
+    void run(const std::function<void(uint)> &job);
+
+private:
+    void loop(uint worker);
+
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+    const std::function<void(uint)> *job;
+    uint generation;
+    uint pending;
+    bool stopping;
+};
+
+/// @brief Fixe le thread courant sur un coeur (sans effet si l'affinité n'est pas disponible).
+/// @param core Numéro du coeur
+void pinThread(uint core);
+}
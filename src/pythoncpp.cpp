@@ -112,7 +112,18 @@ void colorbar() {
 }
 
 namespace np {
-std::string array(int **data, uint rows, uint columns)
+/// @brief Lie varName à un tableau Numpy qui partage la mémoire C++ (aucune copie, aucune conversion en texte).
+/// La mémoire est exposée par une memoryview, placée dans une variable temporaire de __main__ puis lue par np.frombuffer.
+static void wrap(std::string varName, char *data, Py_ssize_t bytes, int access, std::string dtype, std::string shape) {
+    PyObject *main = PyImport_AddModule("__main__");
+    PyObject *view = PyMemoryView_FromMemory(data, bytes, access);
+    PyObject_SetAttrString(main, "_cppBuffer", view);
+    Py_DECREF(view);
+
+    PyRun_SimpleString((varName + " = np.frombuffer(_cppBuffer, dtype=np." + dtype + ").reshape(" + shape + ")\ndel _cppBuffer").c_str());
+}
+
+std::string array(const int8_t *data, uint rows, uint columns)
 {
     std::string varName = randomString(10);
     array(varName, data, rows, columns);
@@ -120,24 +131,10 @@ std::string array(int **data, uint rows, uint columns)
     return varName;
 }
 
-void array(std::string varName, int **data, uint rows, uint columns)
+void array(std::string varName, const int8_t *data, uint rows, uint columns)
 {
-    std::ostringstream ss;
-    ss << "np.array([";
-    for (size_t y = 0; y < rows; y++)
-    {
-        for (size_t x = 0; x < columns; x++)
-        {
-            ss << data[y][x];
-            if (y != rows - 1 || x != columns -1) {
-                ss << ",";
-            }
-        }
-    }
-    ss << "])";
-
-    PyRun_SimpleString((varName + "=" + ss.str()).c_str());
-    reshape(varName, rows, columns);
+    // * Lecture seule : Python ne peut pas modifier le réseau.
+    wrap(varName, (char*)data, (Py_ssize_t)rows * columns, PyBUF_READ, "int8", std::to_string(rows) + "," + std::to_string(columns));
 }
 
 std::string array(double *data, uint length)
@@ -150,18 +147,7 @@ std::string array(double *data, uint length)
 
 void array(std::string varName, double *data, uint length)
 {
-    std::ostringstream ss;
-    ss << "np.array([";
-    for (size_t i = 0; i < length; i++)
-    {
-        ss << data[i];
-        if (i != length - 1) {
-            ss << ",";
-        }
-    }
-    ss << "])";
-
-    PyRun_SimpleString((varName + "=" + ss.str()).c_str());
+    wrap(varName, (char*)data, (Py_ssize_t)length * sizeof(double), PyBUF_WRITE, "float64", std::to_string(length));
 }
 
 void reshape(std::string varName, uint rows, uint columns) {
@@ -172,4 +158,4 @@ void savetxt(std::string varName, std::string filename, std::string delimiter) {
     std::string command = "np.savetxt('" + filename + "'," + varName + ", delimiter='" + delimiter + "')";
     PyRun_SimpleString(command.c_str());
 }
-}
\ No newline at end of file
+}
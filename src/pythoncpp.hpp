@@ -2,6 +2,7 @@
 
 #include <Python.h>
 #include <string>
+#include <stdint.h>
 
 // Ce fichier d'en-tête à pour but de transposer à la quasi-identité les fonctions de Matplotlib et Numpy nécessaire pour le projet.
 // L'objectif est simplement d'exposer des fonctions C/C++ pour exécuter des fonctions Python en arrière.
@@ -55,30 +56,33 @@ void colorbar();
 
 namespace np {
 
-/// @brief Transfère un tableau 2D C++ dans l'interpréteur Python
-/// @param array Tableau de valeurs à transférer
+// Les tableaux Numpy créés ici partagent la mémoire C++ sans la copier : ils reflètent toute modification ultérieure
+// des données, et la mémoire doit rester allouée tant que la variable Python est utilisée.
+
+/// @brief Expose un tableau 2D C++ contigu (ligne par ligne) à l'interpréteur Python, en lecture seule
+/// @param data Tableau de valeurs à exposer
 /// @param rows Nombre de lignes
 /// @param columns Nombre de colonnes
 /// @return Nom de la variable Python créée
-std::string array(int **data, uint rows, uint columns);
+std::string array(const int8_t *data, uint rows, uint columns);
 
-/// @brief Transfère un tableau 2D C++ dans l'interpréteur Python
-/// @param array Tableau de valeurs à transférer
+/// @brief Expose un tableau 2D C++ contigu (ligne par ligne) à l'interpréteur Python, en lecture seule
+/// @param varName Nom de la variable Python à (re)lier
+/// @param data Tableau de valeurs à exposer
 /// @param rows Nombre de lignes
 /// @param columns Nombre de colonnes
-/// @return Nom de la variable Python créée
-void array(std::string varName, int **data, uint rows, uint columns);
+void array(std::string varName, const int8_t *data, uint rows, uint columns);
 
-/// @brief Transfère un tableau 1D C++ dans l'interpréteur Python
-/// @param array Tableau de valeurs à transférer
-/// @param length Nombre de lignes
+/// @brief Expose un tableau 1D C++ à l'interpréteur Python (par exemple un tableau de MC::Properties)
+/// @param data Tableau de valeurs à exposer
+/// @param length Nombre de valeurs
 /// @return Nom de la variable Python créée
 std::string array(double *data, uint length);
 
-/// @brief Transfère un tableau 1D C++ dans l'interpréteur Python
-/// @param array Tableau de valeurs à transférer
-/// @param length Nombre de lignes
-/// @return Nom de la variable Python créée
+/// @brief Expose un tableau 1D C++ à l'interpréteur Python (par exemple un tableau de MC::Properties)
+/// @param varName Nom de la variable Python à (re)lier
+/// @param data Tableau de valeurs à exposer
+/// @param length Nombre de valeurs
 void array(std::string varName, double *data, uint length);
 
 /// @brief Reshape un tableau Numpy dans Python
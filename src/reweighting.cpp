@@ -0,0 +1,200 @@
+#include "reweighting.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+namespace Reweighting {
+
+/// @brief Nombre maximal d'itérations du point fixe des énergies libres.
+#define WHAM_ITERATIONS 100000
+/// @brief Variation maximale d'une énergie libre (ln Z) entre deux itérations à la convergence.
+#define WHAM_TOLERANCE 1e-10
+
+/// @brief Mesures de toutes les simulations regroupées par énergie : à énergie fixée, la loi de M ne dépend pas de T,
+/// les moments de M sont donc sommés sur toutes les simulations.
+struct Histogram {
+    std::vector<double> E;
+    // Nombre de mesures de chaque énergie, toutes simulations confondues
+    std::vector<double> count;
+    std::vector<double> M;
+    std::vector<double> M_sq;
+    std::vector<double> M_abs;
+    double samples;
+};
+
+/// @brief ln Σ exp(x) sans dépassement, terme maximal factorisé.
+static double logSumExp(const std::vector<double> &x) {
+    const double top = *std::max_element(x.begin(), x.end());
+    if (!std::isfinite(top)) {
+        return top;
+    }
+    double sum = 0;
+    for (double value : x) {
+        sum += std::exp(value - top);
+    }
+    return top + std::log(sum);
+}
+
+static Histogram histogram(const std::vector<Run> &runs) {
+    Histogram hist = Histogram();
+    std::map<double, uint> index;
+    for (const Run &run : runs) {
+        for (double E : run.E) {
+            index.emplace(E, 0);
+        }
+    }
+    for (auto &entry : index) {
+        entry.second = hist.E.size();
+        hist.E.push_back(entry.first);
+    }
+
+    const size_t energies = hist.E.size();
+    hist.count.assign(energies, 0);
+    hist.M.assign(energies, 0);
+    hist.M_sq.assign(energies, 0);
+    hist.M_abs.assign(energies, 0);
+
+    for (size_t k = 0; k < runs.size(); k++) {
+        for (size_t t = 0; t < runs[k].E.size(); t++) {
+            const uint u = index[runs[k].E[t]];
+            const double M = runs[k].M[t];
+            hist.count[u]++;
+            hist.M[u] += M;
+            hist.M_sq[u] += M * M;
+            hist.M_abs[u] += fabs(M);
+        }
+        hist.samples += runs[k].E.size();
+    }
+    return hist;
+}
+
+/// @brief ln du dénominateur WHAM de chaque énergie : ln Σ_k n_k exp(-β_k E - ln Z_k).
+static std::vector<double> logDenominator(const Histogram &hist, const std::vector<Run> &runs, const std::vector<double> &beta, const std::vector<double> &logZ) {
+    std::vector<double> out(hist.E.size());
+    std::vector<double> terms(runs.size());
+    for (size_t u = 0; u < hist.E.size(); u++) {
+        for (size_t k = 0; k < runs.size(); k++) {
+            terms[k] = std::log((double)runs[k].E.size()) - beta[k] * hist.E[u] - logZ[k];
+        }
+        out[u] = logSumExp(terms);
+    }
+    return out;
+}
+
+/// @brief Point fixe des énergies libres ln Z_k, ln Z_0 étant fixé à 0.
+static std::vector<double> freeEnergies(const Histogram &hist, const std::vector<Run> &runs, const std::vector<double> &beta) {
+    std::vector<double> logZ(runs.size(), 0);
+    std::vector<double> terms(hist.E.size());
+
+    for (uint iteration = 0; iteration < WHAM_ITERATIONS && runs.size() > 1; iteration++) {
+        const std::vector<double> logD = logDenominator(hist, runs, beta, logZ);
+        std::vector<double> next(runs.size());
+        for (size_t k = 0; k < runs.size(); k++) {
+            for (size_t u = 0; u < hist.E.size(); u++) {
+                terms[u] = std::log(hist.count[u]) - beta[k] * hist.E[u] - logD[u];
+            }
+            next[k] = logSumExp(terms);
+        }
+
+        double change = 0;
+        for (size_t k = 0; k < runs.size(); k++) {
+            next[k] -= next[0];
+            change = std::max(change, fabs(next[k] - logZ[k]));
+        }
+        logZ = next;
+        if (change < WHAM_TOLERANCE) {
+            break;
+        }
+    }
+    return logZ;
+}
+
+/// @brief Moyennes à chaque température de la grille, à partir des ln poids -ln D(E) de chaque énergie.
+static MC::Properties reweight(const Histogram &hist, const std::vector<double> &logD, double kB, double Ti, double Tf, uint samplingPoints) {
+    assert(samplingPoints > 1);
+    MC::Properties props = MC::properties(samplingPoints);
+    const double dT = (Tf - Ti) / (samplingPoints - 1);
+    std::vector<double> logWeight(hist.E.size());
+
+    for (uint i = 0; i < samplingPoints; i++) {
+        const double T = Ti + i * dT;
+        const double beta = 1 / (kB * T);
+        for (size_t u = 0; u < hist.E.size(); u++) {
+            logWeight[u] = std::log(hist.count[u]) - beta * hist.E[u] - logD[u];
+        }
+        const double norm = logSumExp(logWeight);
+
+        double E = 0, E_sq = 0, M = 0, M_sq = 0, M_abs = 0;
+        for (size_t u = 0; u < hist.E.size(); u++) {
+            // * Poids de l'énergie normalisé, réparti sur ses count mesures pour les moments de M.
+            const double w = std::exp(logWeight[u] - norm);
+            const double perSample = w / hist.count[u];
+            E += w * hist.E[u];
+            E_sq += w * hist.E[u] * hist.E[u];
+            M += perSample * hist.M[u];
+            M_sq += perSample * hist.M_sq[u];
+            M_abs += perSample * hist.M_abs[u];
+        }
+
+        props.T[i] = T;
+        props.E[i] = E;
+        props.E_sq[i] = E_sq;
+        props.M[i] = M;
+        props.M_sq[i] = M_sq;
+        props.M_abs[i] = M_abs;
+        props.samples[i] = 1;
+        props.mcSteps[i] = hist.samples;
+    }
+    return props;
+}
+
+void split(const std::vector<Series::Record> &records, std::vector<Run> &runs) {
+    for (size_t t = 0; t < records.size(); t++) {
+        const Series::Record &record = records[t];
+        if (t == 0 || record.T != records[t - 1].T || record.h != records[t - 1].h) {
+            runs.push_back({ record.T, record.h, {}, {} });
+        }
+        runs.back().E.push_back(record.E);
+        runs.back().M.push_back(record.M);
+    }
+}
+
+bool read(const std::string &fileName, std::vector<Run> &runs) {
+    std::vector<Series::Record> records;
+    if (!Series::read(fileName, records)) {
+        return false;
+    }
+    split(records, runs);
+    return true;
+}
+
+MC::Properties singleHistogram(const Run &run, double kB, double Ti, double Tf, uint samplingPoints) {
+    const std::vector<Run> runs = { run };
+    const Histogram hist = histogram(runs);
+
+    // * Ferrenberg-Swendsen : le poids d'une énergie à β est exp(-(β - β0) E), soit D(E) = exp(-β0 E) à une constante près.
+    std::vector<double> logD(hist.E.size());
+    for (size_t u = 0; u < hist.E.size(); u++) {
+        logD[u] = - hist.E[u] / (kB * run.T);
+    }
+    return reweight(hist, logD, kB, Ti, Tf, samplingPoints);
+}
+
+MC::Properties multiHistogram(const std::vector<Run> &runs, double kB, double Ti, double Tf, uint samplingPoints) {
+    assert(!runs.empty());
+    std::vector<double> beta(runs.size());
+    for (size_t k = 0; k < runs.size(); k++) {
+        beta[k] = 1 / (kB * runs[k].T);
+        if (runs[k].h != runs[0].h) {
+            std::cerr << "[Reweighting] Runs at different fields (h = " << runs[0].h << ", " << runs[k].h << ")\n";
+        }
+    }
+
+    const Histogram hist = histogram(runs);
+    const std::vector<double> logZ = freeEnergies(hist, runs, beta);
+    return reweight(hist, logDenominator(hist, runs, beta, logZ), kB, Ti, Tf, samplingPoints);
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "montecarlo.hpp"
+#include "series.hpp"
+
+#include <string>
+#include <vector>
+
+// Repondération d'histogrammes : les mesures (E, M) de quelques simulations à température fixée, typiquement la série
+// temporelle d'un thermalizeLattice à 5-10 points (options.series), donnent les grandeurs moyennes à toute température
+// voisine. Une seule simulation : Ferrenberg-Swendsen. Plusieurs : combinaison optimale (multi-histogramme, WHAM),
+// dont les énergies libres sont obtenues par itération de point fixe. Les mesures sont regroupées par valeur exacte de
+// l'énergie, et toutes les sommes de poids exp(-E/kT) sont évaluées en log-sum-exp.
+// Les propriétés produites ont une mesure par point (samples = 1) et s'écrivent avec les mêmes colonnes que saveProps.
+// ! Le champ h doit être le même pour toutes les simulations, et les mesures supposées peu corrélées (targetError > 0).
+// ! Le résultat n'est fiable qu'entre les températures simulées, ou à moins d'un écart-type d'énergie de l'une d'elles.
+
+namespace Reweighting {
+
+/// @brief Mesures d'une simulation à T et h fixés.
+struct Run {
+    double T;
+    double h;
+    std::vector<double> E;
+    std::vector<double> M;
+};
+
+/// @brief Découpe une série en simulations : chaque suite de mesures consécutives de même (T, h) en forme une.
+/// @param records Mesures de la série
+/// @param runs Simulations (ajoutées à la fin)
+void split(const std::vector<Series::Record> &records, std::vector<Run> &runs);
+
+/// @brief Relit une série écrite par Series::Writer et la découpe en simulations (voir split).
+/// @return false si la série est illisible
+bool read(const std::string &fileName, std::vector<Run> &runs);
+
+/// @brief Repondération d'une seule simulation (Ferrenberg-Swendsen) sur une grille de températures.
+/// @param run Simulation
+/// @param kB Constante de Boltzmann
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param samplingPoints Nombre de points de la grille
+/// @return Propriétés à une mesure par point, mcSteps contenant le nombre de mesures utilisées
+MC::Properties singleHistogram(const Run &run, double kB, double Ti, double Tf, uint samplingPoints);
+
+/// @brief Repondération combinée de plusieurs simulations (WHAM) sur une grille de températures.
+/// @param runs Simulations, au même champ h
+/// @param kB Constante de Boltzmann
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param samplingPoints Nombre de points de la grille
+/// @return Propriétés à une mesure par point, mcSteps contenant le nombre de mesures utilisées
+MC::Properties multiHistogram(const std::vector<Run> &runs, double kB, double Ti, double Tf, uint samplingPoints);
+}
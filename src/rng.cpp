@@ -0,0 +1,57 @@
+#include "rng.hpp"
+
+namespace RNG {
+
+/// @brief Fonction de mélange de splitmix64, utilisée pour initialiser l'état à partir de la graine.
+static uint64_t splitmix(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+Generator generator(uint64_t seed, uint64_t stream) {
+    // * Le numéro de flux est mélangé avant d'être combiné à la graine : des flux consécutifs
+    // * ne partagent pas de sous-suite de splitmix64.
+    uint64_t mixedStream = stream;
+    uint64_t x = seed ^ splitmix(mixedStream);
+
+    Generator g = Generator();
+    for (int i = 0; i < 4; i++) {
+        g.s[i] = splitmix(x);
+    }
+    return g;
+}
+
+void jump(Generator &g) {
+    static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ULL << b)) {
+                for (int k = 0; k < 4; k++) {
+                    s[k] ^= g.s[k];
+                }
+            }
+            next(g);
+        }
+    }
+
+    for (int k = 0; k < 4; k++) {
+        g.s[k] = s[k];
+    }
+}
+
+void uniform(Generator &g, double *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = uniform(g);
+    }
+}
+
+void bounded(Generator &g, const uint32_t n, uint32_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = bounded(g, n);
+    }
+}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "telemetry.hpp"
+
+// Générateur pseudo-aléatoire xoshiro256** (Blackman & Vigna) : chaque réseau, réplique ou thread possède
+// son propre flux, il n'y a plus d'état global partagé comme avec std::rand().
+
+namespace RNG {
+/// @brief Etat d'un flux xoshiro256**.
+struct Generator {
+    uint64_t s[4];
+};
+
+/// @brief Initialise un flux à partir d'une graine et d'un numéro de flux.
+/// Deux couples (seed, stream) différents donnent des flux décorrélés, ce qui rend les exécutions parallèles reproductibles.
+/// @param seed Graine de la simulation
+/// @param stream Numéro du flux (réseau, réplique, thread ...)
+/// @return Générateur initialisé
+Generator generator(uint64_t seed, uint64_t stream);
+
+/// @brief Avance le flux de 2^128 tirages : garantit des sous-flux sans recouvrement.
+/// @param g Générateur
+void jump(Generator &g);
+
+inline uint64_t rotl(const uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/// @brief Tire un entier de 64 bits uniforme.
+/// @param g Générateur
+/// @return Entier aléatoire
+inline uint64_t next(Generator &g) {
+    uint64_t *s = g.s;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    TELEMETRY_ADD(rngDraws, 1);
+    return result;
+}
+
+/// @brief Tire un réel uniforme dans [0, 1).
+/// @param g Générateur
+/// @return Réel aléatoire
+inline double uniform(Generator &g) {
+    return (next(g) >> 11) * 0x1.0p-53;
+}
+
+/// @brief Tire un entier uniforme dans [0, n) sans biais (méthode de Lemire).
+/// @param g Générateur
+/// @param n Borne supérieure exclue
+/// @return Entier aléatoire
+inline uint32_t bounded(Generator &g, const uint32_t n) {
+    uint64_t m = (next(g) >> 32) * n;
+    if ((uint32_t)m < n) {
+        const uint32_t threshold = -n % n;
+        while ((uint32_t)m < threshold) {
+            m = (next(g) >> 32) * n;
+        }
+    }
+    return m >> 32;
+}
+
+/// @brief Remplit un tableau de réels uniformes dans [0, 1).
+/// @param g Générateur
+/// @param out Tableau à remplir
+/// @param count Nombre de tirages
+void uniform(Generator &g, double *out, size_t count);
+
+/// @brief Remplit un tableau d'entiers uniformes dans [0, n), typiquement des indices de site.
+/// @param g Générateur
+/// @param n Borne supérieure exclue
+/// @param out Tableau à remplir
+/// @param count Nombre de tirages
+void bounded(Generator &g, const uint32_t n, uint32_t *out, size_t count);
+}
@@ -0,0 +1,198 @@
+#include "series.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifdef ISING_ZLIB
+#include <zlib.h>
+#endif
+
+namespace Series {
+
+static const char MAGIC[8] = { 'I', 'S', 'I', 'N', 'G', 'T', 'S', '1' };
+
+Writer::Writer(const std::string &fileName, size_t capacity, bool compress) {
+    size_t size = SERIES_BLOCK;
+    while (size < capacity) {
+        size *= 2;
+    }
+    ring.resize(size);
+    mask = size - 1;
+    waits = 0;
+    head = 0;
+    tail = 0;
+    running = true;
+
+#ifdef ISING_ZLIB
+    this->compress = compress;
+#else
+    this->compress = false;
+#endif
+
+    file = fopen(fileName.c_str(), "wb");
+    if (file == nullptr) {
+        std::cerr << "[Series] Cannot open " << fileName << "\n";
+    }
+    else {
+        const uint32_t flag = this->compress;
+        fwrite(MAGIC, 1, 8, file);
+        fwrite(&flag, sizeof(flag), 1, file);
+    }
+    thread = std::thread(&Writer::loop, this);
+}
+
+Writer::~Writer() {
+    running.store(false, std::memory_order_release);
+    thread.join();
+    if (file != nullptr) {
+        fclose(file);
+    }
+}
+
+void Writer::push(const Record &record) {
+    const size_t position = head.load(std::memory_order_relaxed);
+    if (position - tail.load(std::memory_order_acquire) > mask) {
+        waits++;
+        while (position - tail.load(std::memory_order_acquire) > mask) {
+            std::this_thread::yield();
+        }
+    }
+    ring[position & mask] = record;
+    head.store(position + 1, std::memory_order_release);
+}
+
+uint64_t Writer::stalls() const {
+    return waits;
+}
+
+void Writer::loop() {
+    std::vector<Record> block;
+    block.reserve(SERIES_BLOCK);
+
+    while (true) {
+        // * running est lu avant head : une fois l'arrêt vu, toutes les mesures déposées avant sont visibles.
+        const bool stopping = !running.load(std::memory_order_acquire);
+        const size_t available = head.load(std::memory_order_acquire);
+        size_t position = tail.load(std::memory_order_relaxed);
+        const size_t first = position;
+
+        while (position < available) {
+            block.push_back(ring[position & mask]);
+            position++;
+            if (block.size() == SERIES_BLOCK) {
+                tail.store(position, std::memory_order_release);
+                writeBlock(block);
+                block.clear();
+            }
+        }
+        tail.store(position, std::memory_order_release);
+
+        if (stopping) {
+            break;
+        }
+        if (available == first) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    if (!block.empty()) {
+        writeBlock(block);
+    }
+}
+
+void Writer::writeBlock(const std::vector<Record> &block) {
+    if (file == nullptr) {
+        return;
+    }
+
+    // * Disposition en colonnes : chaque colonne d'un bloc est contiguë, et T et h, presque constants, se compressent très bien.
+    const uint32_t count = block.size();
+    std::vector<double> columns(4 * count);
+    for (uint32_t k = 0; k < count; k++) {
+        columns[k] = block[k].T;
+        columns[count + k] = block[k].h;
+        columns[2 * count + k] = block[k].E;
+        columns[3 * count + k] = block[k].M;
+    }
+    const char *data = (const char*)columns.data();
+    uint32_t bytes = sizeof(double) * columns.size();
+
+#ifdef ISING_ZLIB
+    std::vector<Bytef> packed;
+    if (compress) {
+        uLongf packedSize = compressBound(bytes);
+        packed.resize(packedSize);
+        compress2(packed.data(), &packedSize, (const Bytef*)data, bytes, Z_BEST_SPEED);
+        data = (const char*)packed.data();
+        bytes = packedSize;
+    }
+#endif
+
+    fwrite(&count, sizeof(count), 1, file);
+    fwrite(&bytes, sizeof(bytes), 1, file);
+    fwrite(data, 1, bytes, file);
+}
+
+bool read(const std::string &fileName, std::vector<Record> &records) {
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[8];
+    uint32_t compressed = 0;
+    if (!file.read(magic, 8) || !file.read((char*)&compressed, sizeof(compressed)) || memcmp(magic, MAGIC, 8) != 0) {
+        return false;
+    }
+#ifndef ISING_ZLIB
+    if (compressed) {
+        std::cerr << "[Series] " << fileName << " is compressed, rebuild with -DISING_ZLIB\n";
+        return false;
+    }
+#endif
+
+    uint32_t count, bytes;
+    std::vector<char> data;
+    std::vector<double> columns;
+    while (file.read((char*)&count, sizeof(count)) && file.read((char*)&bytes, sizeof(bytes))) {
+        data.resize(bytes);
+        columns.resize(4 * count);
+        if (!file.read(data.data(), bytes)) {
+            return false;
+        }
+
+        if (compressed) {
+#ifdef ISING_ZLIB
+            uLongf size = sizeof(double) * columns.size();
+            if (uncompress((Bytef*)columns.data(), &size, (const Bytef*)data.data(), bytes) != Z_OK || size != sizeof(double) * columns.size()) {
+                return false;
+            }
+#endif
+        }
+        else if (bytes == sizeof(double) * columns.size()) {
+            memcpy(columns.data(), data.data(), bytes);
+        }
+        else {
+            return false;
+        }
+
+        for (uint32_t k = 0; k < count; k++) {
+            records.push_back({ columns[k], columns[count + k], columns[2 * count + k], columns[3 * count + k] });
+        }
+    }
+    return true;
+}
+
+bool exportCsv(const std::string &fileName, const std::string &csvName) {
+    std::vector<Record> records;
+    if (!read(fileName, records)) {
+        return false;
+    }
+
+    std::fstream file;
+    file.open(csvName, std::ios::out);
+    for (const Record &record : records) {
+        file << record.T << ";" << record.h << ";" << record.E << ";" << record.M << "\n";
+    }
+    file.close();
+    return true;
+}
+}
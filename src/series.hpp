@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+// Enregistrement en continu des séries temporelles (T, h, E, M) d'une simulation, pour la repondération et l'analyse
+// d'autocorrélation hors ligne. Le thread de simulation dépose les mesures dans un tampon circulaire sans verrou
+// (un producteur, un consommateur) ; un thread dédié les regroupe par blocs et les écrit sur disque.
+// Format : en-tête "ISINGTS1" et un drapeau de compression (uint32), puis des blocs [nombre de mesures (uint32),
+// taille des données (uint32), données] où les données sont les colonnes T, h, E et M du bloc l'une après l'autre,
+// compressées par zlib si demandé (compilation avec -DISING_ZLIB).
+
+namespace Series {
+
+/// @brief Nombre de mesures par bloc écrit.
+#define SERIES_BLOCK 4096
+
+/// @brief Une mesure de la série.
+struct Record {
+    double T;
+    double h;
+    double E;
+    double M;
+};
+
+/// @brief Ecrivain de série temporelle avec thread d'écriture dédié.
+class Writer {
+public:
+    /// @brief Ouvre le fichier et démarre le thread d'écriture.
+    /// @param fileName Chemin du fichier (écrasé)
+    /// @param capacity Capacité du tampon circulaire en mesures (arrondie à une puissance de 2)
+    /// @param compress Compression zlib des blocs (ignorée sans ISING_ZLIB)
+    Writer(const std::string &fileName, size_t capacity, bool compress);
+
+    /// @brief Vide le tampon, écrit le dernier bloc et ferme le fichier.
+    ~Writer();
+
+    /// @brief Dépose une mesure, sans appel système. Si l'écriture ne suit pas et que le tampon est plein,
+    /// attend qu'une place se libère (compté dans stalls()).
+    // ! Un seul thread producteur : deux appels concurrents perdent ou écrasent des mesures sans erreur. Les simulations
+    // ! parallèles (thermalizeLatticeParallel, magnetizeLatticeParallel) n'alimentent donc pas la série.
+    void push(const Record &record);
+
+    /// @brief Nombre de fois où push() a dû attendre le thread d'écriture.
+    uint64_t stalls() const;
+
+private:
+    void loop();
+    void writeBlock(const std::vector<Record> &block);
+
+    FILE *file;
+    bool compress;
+    std::vector<Record> ring;
+    size_t mask;
+    uint64_t waits;
+
+    // * Indices de lecture et d'écriture sur des lignes de cache distinctes : pas de faux partage entre les deux threads.
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+    alignas(64) std::atomic<bool> running;
+    std::thread thread;
+};
+
+/// @brief Relit entièrement une série écrite par Writer.
+/// @param fileName Chemin du fichier
+/// @param records Mesures relues (ajoutées à la fin)
+/// @return false si le fichier est illisible, tronqué, ou compressé sans support zlib
+bool read(const std::string &fileName, std::vector<Record> &records);
+
+/// @brief Exporte une série en texte, une mesure par ligne "T;h;E;M".
+/// @return false si la série est illisible
+bool exportCsv(const std::string &fileName, const std::string &csvName);
+}
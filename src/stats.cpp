@@ -0,0 +1,118 @@
+#include "stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Stats {
+
+Binning binning() {
+    return Binning();
+}
+
+void add(Binning &bins, double value) {
+    // * Chaque paire de blocs complets d'un niveau forme un bloc du niveau suivant.
+    for (uint level = 0; level < BINNING_LEVELS; level++) {
+        bins.count[level]++;
+        bins.sum[level] += value;
+        bins.sumSq[level] += value * value;
+
+        if (!bins.hasPending[level]) {
+            bins.pending[level] = value;
+            bins.hasPending[level] = true;
+            return;
+        }
+        value = (bins.pending[level] + value) / 2;
+        bins.hasPending[level] = false;
+    }
+}
+
+double mean(const Binning &bins) {
+    return bins.count[0] > 0 ? bins.sum[0] / bins.count[0] : 0;
+}
+
+double error(const Binning &bins, uint level) {
+    const double n = bins.count[level];
+    if (n < 2) {
+        return 0;
+    }
+    const double average = bins.sum[level] / n;
+    const double variance = std::max(0.0, bins.sumSq[level] / n - average * average);
+    return std::sqrt(variance / (n - 1));
+}
+
+double error(const Binning &bins) {
+    double err = error(bins, 0);
+    for (uint level = 1; level < BINNING_LEVELS && bins.count[level] >= BINNING_MIN_BLOCKS; level++) {
+        err = std::max(err, error(bins, level));
+    }
+    return err;
+}
+
+double autocorrelationTime(const Binning &bins) {
+    const double naive = error(bins, 0);
+    if (naive == 0) {
+        return 0;
+    }
+    const double ratio = error(bins) / naive;
+    return (ratio * ratio - 1) / 2;
+}
+
+RingBuffer ringBuffer() {
+    return RingBuffer();
+}
+
+void push(RingBuffer &window, double value) {
+    window.values[window.head] = value;
+    window.head = (window.head + 1) % RING_CAPACITY;
+    window.count = std::min(window.count + 1, (uint)RING_CAPACITY);
+}
+
+void moments(const RingBuffer &window, uint first, uint last, double &mean, double &variance) {
+    double sum = 0;
+    double sumSq = 0;
+    for (uint k = first; k < last; k++) {
+        const double value = at(window, k);
+        sum += value;
+        sumSq += value * value;
+    }
+    const double n = last - first;
+    mean = sum / n;
+    variance = std::max(0.0, sumSq / n - mean * mean);
+}
+
+double geweke(const RingBuffer &window) {
+    double meanA, varA, meanB, varB;
+    const uint nA = window.count / 10;
+    const uint nB = window.count / 2;
+    moments(window, 0, nA, meanA, varA);
+    moments(window, window.count - nB, window.count, meanB, varB);
+
+    const double sigma = std::sqrt(varA / nA + varB / nB);
+    if (sigma == 0) {
+        return meanA == meanB ? 0 : INFINITY;
+    }
+    return std::fabs(meanA - meanB) / sigma;
+}
+
+uint mserTruncation(const RingBuffer &window) {
+    // * Sommes suffixes parcourues depuis la fin : la statistique de chaque d est calculée en O(1).
+    double sum = 0;
+    double sumSq = 0;
+    double best = INFINITY;
+    uint truncation = 0;
+
+    for (uint d = window.count; d-- > 0;) {
+        const double value = at(window, d);
+        sum += value;
+        sumSq += value * value;
+
+        const double n = window.count - d;
+        const double statistic = std::max(0.0, sumSq - sum * sum / n) / (n * n);
+        if (d <= window.count / 2 && statistic <= best) {
+            best = statistic;
+            truncation = d;
+        }
+    }
+    return truncation;
+}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// Analyse statistique en ligne des séries de mesures : moyenne, erreur par la méthode des blocs (binning)
+// et temps d'autocorrélation intégré, sans conserver la série elle-même.
+
+namespace Stats {
+
+/// @brief Nombre de niveaux de blocs : des blocs de 1 à 2^(BINNING_LEVELS - 1) mesures.
+#define BINNING_LEVELS 32
+/// @brief Nombre minimal de blocs complets pour qu'un niveau soit pris en compte dans l'estimation de l'erreur.
+#define BINNING_MIN_BLOCKS 32
+
+/// @brief Accumulateur de la méthode des blocs : au niveau l, chaque bloc est la moyenne de 2^l mesures consécutives.
+/// Ajouter une mesure coûte O(1) en moyenne et la mémoire est fixe.
+struct Binning {
+    uint64_t count[BINNING_LEVELS];
+    double sum[BINNING_LEVELS];
+    double sumSq[BINNING_LEVELS];
+
+    // Premier bloc d'une paire en attente de son second bloc, au niveau l
+    double pending[BINNING_LEVELS];
+    bool hasPending[BINNING_LEVELS];
+};
+
+/// @brief Construit un accumulateur vide.
+Binning binning();
+
+/// @brief Ajoute une mesure à la série.
+/// @param bins Accumulateur
+/// @param value Mesure
+void add(Binning &bins, double value);
+
+/// @brief Moyenne de toutes les mesures ajoutées.
+double mean(const Binning &bins);
+
+/// @brief Erreur sur la moyenne estimée à partir des blocs du niveau level, supposés indépendants.
+/// @param bins Accumulateur
+/// @param level Niveau des blocs
+/// @return Ecart-type de la moyenne (0 s'il y a moins de deux blocs)
+double error(const Binning &bins, uint level);
+
+/// @brief Erreur sur la moyenne corrigée des corrélations : maximum de l'erreur sur les niveaux ayant au moins
+/// BINNING_MIN_BLOCKS blocs. Elle croît avec le niveau jusqu'à ce que les blocs soient décorrélés, puis se stabilise.
+double error(const Binning &bins);
+
+/// @brief Temps d'autocorrélation intégré, en nombre de mesures : τ = (σ²_blocs / σ²_0 - 1) / 2.
+/// Vaut 0 pour des mesures indépendantes.
+double autocorrelationTime(const Binning &bins);
+
+/// @brief Capacité de la fenêtre glissante d'observables.
+#define RING_CAPACITY 256
+
+/// @brief Fenêtre glissante des RING_CAPACITY dernières valeurs d'une observable (les plus anciennes sont écrasées).
+struct RingBuffer {
+    double values[RING_CAPACITY];
+    uint head;
+    uint count;
+};
+
+/// @brief Construit une fenêtre vide.
+RingBuffer ringBuffer();
+
+/// @brief Ajoute une valeur à la fenêtre, en écrasant la plus ancienne si elle est pleine.
+void push(RingBuffer &window, double value);
+
+/// @brief k-ième valeur de la fenêtre, de la plus ancienne (k = 0) à la plus récente (k = count - 1).
+inline double at(const RingBuffer &window, uint k) {
+    return window.values[(window.head + RING_CAPACITY - window.count + k) % RING_CAPACITY];
+}
+
+/// @brief Moyenne et variance des valeurs k de [first, last[ de la fenêtre.
+void moments(const RingBuffer &window, uint first, uint last, double &mean, double &variance);
+
+/// @brief Score de Geweke : écart entre la moyenne du premier dixième et celle de la seconde moitié de la fenêtre,
+/// en nombre d'écarts-types de la différence. Les écarts-types ignorent la corrélation, ce qui rend le test plus strict.
+/// @return |z|, nul si les deux moyennes sont égales et sans fluctuation
+double geweke(const RingBuffer &window);
+
+/// @brief Point de troncature MSER (Marginal Standard Error Rule) : le nombre d de valeurs initiales à écarter qui
+/// minimise Σ_{k >= d} (x_k - moyenne_d)² / (count - d)². Calculé en O(count) par sommes suffixes.
+/// @return d, entre 0 et count / 2 (au-delà, la statistique n'est plus significative)
+uint mserTruncation(const RingBuffer &window);
+}
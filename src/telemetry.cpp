@@ -0,0 +1,134 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Telemetry {
+
+static std::mutex registryMutex;
+// * Counters n'est qu'une suite de Counter (jusqu'à sites) : l'agrégation se fait champ par champ.
+static const uint COUNTERS = offsetof(Counters, sites) / sizeof(Counter) + 1;
+// * Compteurs des threads vivants, et cumul de ceux des threads terminés : le registre ne grandit pas avec
+// * les threads créés à chaque appel (équipes temporaires, Parallel::forEach).
+static std::vector<Counters*> registry;
+static Counters retired;
+
+/// @brief Compteurs d'un thread, reversés dans retired et retirés du registre à la fin du thread.
+struct Holder {
+    Counters *counters = nullptr;
+
+    ~Holder() {
+        if (counters == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registryMutex);
+        const Counter *counter = (const Counter*)counters;
+        Counter *sum = (Counter*)&retired;
+        for (uint k = 0; k + 1 < COUNTERS; k++) {
+            sum[k].add(counter[k].get());
+        }
+        retired.sites.value.store(std::max(retired.sites.get(), counters->sites.get()), std::memory_order_relaxed);
+        registry.erase(std::find(registry.begin(), registry.end(), counters));
+        delete counters;
+    }
+};
+
+Counters &local() {
+    thread_local Holder holder;
+    if (holder.counters == nullptr) {
+        holder.counters = new Counters();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(holder.counters);
+    }
+    return *holder.counters;
+}
+
+void recordCluster(uint64_t size) {
+    Counters &counters = local();
+    const uint bucket = std::min(63 - __builtin_clzll(std::max<uint64_t>(size, 1)), CLUSTER_BUCKETS - 1);
+    counters.clusters.add(1);
+    counters.clusterHistogram[bucket].add(1);
+}
+
+void total(Counters &sum) {
+    uint64_t values[COUNTERS] = {};
+    // * La taille du réseau n'est pas une somme : on garde la plus grande.
+    uint64_t sites = retired.sites.get();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        const Counter *past = (const Counter*)&retired;
+        for (uint k = 0; k + 1 < COUNTERS; k++) {
+            values[k] = past[k].get();
+        }
+        for (const Counters *counters : registry) {
+            const Counter *counter = (const Counter*)counters;
+            for (uint k = 0; k + 1 < COUNTERS; k++) {
+                values[k] += counter[k].get();
+            }
+            sites = std::max(sites, counters->sites.get());
+        }
+    }
+
+    Counter *out = (Counter*)&sum;
+    for (uint k = 0; k + 1 < COUNTERS; k++) {
+        out[k].value.store(values[k], std::memory_order_relaxed);
+    }
+    sum.sites.value.store(sites, std::memory_order_relaxed);
+}
+
+static std::thread dumper;
+static std::mutex dumpMutex;
+static std::condition_variable dumpCondition;
+static bool dumping = false;
+
+static void writeLine(std::ofstream &file, std::chrono::steady_clock::time_point origin) {
+    Counters sum;
+    total(sum);
+    const double attempts = sum.attempts.get();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+
+    file << "time=" << seconds;
+    file << " attempts=" << sum.attempts.get() << " accepted=" << sum.accepted.get();
+    file << " acceptance=" << (attempts > 0 ? sum.accepted.get() / attempts : 0);
+    file << " rngDrawsPerUpdate=" << (attempts > 0 ? sum.rngDraws.get() / attempts : 0);
+    file << " iterations=" << sum.iterations.get();
+    file << " nsPerSweep=" << (attempts > 0 ? sum.nanoseconds.get() * (double)sum.sites.get() / attempts : 0);
+    file << " equilibrations=" << sum.equilibrations.get();
+    file << " meanEquilibrationSteps=" << (sum.equilibrations.get() > 0 ? sum.equilibrationSteps.get() / (double)sum.equilibrations.get() : 0);
+    file << " clusters=" << sum.clusters.get() << " clusterHistogram=";
+    for (uint k = 0; k < CLUSTER_BUCKETS; k++) {
+        file << sum.clusterHistogram[k].get() << (k + 1 < CLUSTER_BUCKETS ? "," : "\n");
+    }
+    file.flush();
+}
+
+void startDump(const std::string &fileName, double period) {
+    stopDump();
+    dumping = true;
+    dumper = std::thread([fileName, period]() {
+        std::ofstream file(fileName, std::ios::app);
+        const auto origin = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(dumpMutex);
+        while (dumping) {
+            dumpCondition.wait_for(lock, std::chrono::duration<double>(period), []() { return !dumping; });
+            writeLine(file, origin);
+        }
+    });
+}
+
+void stopDump() {
+    {
+        std::lock_guard<std::mutex> lock(dumpMutex);
+        dumping = false;
+    }
+    dumpCondition.notify_all();
+    if (dumper.joinable()) {
+        dumper.join();
+    }
+}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <sys/types.h>
+
+// Compteurs de télémétrie des chemins critiques, compilés uniquement avec -DISING_TELEMETRY (sinon les macros
+// TELEMETRY_* ne génèrent aucun code). Chaque thread incrémente ses propres compteurs, sans instruction atomique
+// verrouillée ni partage de ligne de cache ; un thread de vidage les agrège périodiquement dans un fichier.
+
+namespace Telemetry {
+
+/// @brief Nombre de classes de l'histogramme des tailles de cluster : la classe k compte les tailles de [2^k, 2^(k+1)).
+#define CLUSTER_BUCKETS 32
+
+/// @brief Compteur à un seul écrivain : lecture et écriture relâchées, lisible sans course par le thread de vidage.
+struct Counter {
+    std::atomic<uint64_t> value;
+
+    inline void add(uint64_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    inline uint64_t get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+};
+
+/// @brief Compteurs d'un thread.
+struct alignas(64) Counters {
+    Counter attempts;               // Mises à jour de spin tentées
+    Counter accepted;               // Mises à jour de spin acceptées
+    Counter rngDraws;               // Tirages de 64 bits du générateur
+    Counter iterations;             // Appels à options.mcIterator pendant les mesures et l'équilibrage
+    Counter nanoseconds;            // Durée de ces appels
+    Counter equilibrations;         // Appels à reachEquilibrium
+    Counter equilibrationSteps;     // Itérations d'équilibrage
+    Counter clusters;               // Clusters construits (Wolff) et leur histogramme de tailles
+    Counter clusterHistogram[CLUSTER_BUCKETS];
+    Counter sites;                  // Taille du dernier réseau simulé
+};
+
+/// @brief Compteurs du thread courant, créés et enregistrés au premier appel, et reversés dans un cumul à la fin du thread.
+Counters &local();
+
+/// @brief Ajoute un cluster de la taille donnée à l'histogramme du thread courant.
+void recordCluster(uint64_t size);
+
+/// @brief Somme des compteurs de tous les threads (y compris terminés).
+void total(Counters &sum);
+
+/// @brief Démarre un thread qui ajoute toutes les period secondes une ligne de métriques à fileName.
+/// Une ligne contient des couples clé=valeur : compteurs bruts, taux d'acceptation, tirages par mise à jour,
+/// temps par balayage (ns), étapes d'équilibrage moyennes et histogramme des clusters.
+void startDump(const std::string &fileName, double period);
+
+/// @brief Arrête le thread de vidage après une dernière ligne.
+void stopDump();
+
+/// @brief Chronomètre de portée : ajoute sa durée de vie aux nanosecondes du thread courant.
+class Timer {
+public:
+    Timer() : start(std::chrono::steady_clock::now()) {}
+    ~Timer() {
+        local().nanoseconds.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+}
+
+#ifdef ISING_TELEMETRY
+#define TELEMETRY_ADD(counter, n) (Telemetry::local().counter.add(n))
+#define TELEMETRY_SET(counter, n) (Telemetry::local().counter.value.store(n, std::memory_order_relaxed))
+#define TELEMETRY_CLUSTER(size) (Telemetry::recordCluster(size))
+#define TELEMETRY_TIMER(name) Telemetry::Timer name
+#else
+// * Les arguments sont évalués pour être consommés (pas d'avertissement de variable inutilisée), puis éliminés.
+#define TELEMETRY_ADD(counter, n) ((void)(n))
+#define TELEMETRY_SET(counter, n) ((void)(n))
+#define TELEMETRY_CLUSTER(size) ((void)(size))
+#define TELEMETRY_TIMER(name) ((void)0)
+#endif
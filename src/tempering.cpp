@@ -0,0 +1,109 @@
+#include "tempering.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace MC {
+
+/// @brief Etat d'une réplique : son réseau et ses grandeurs suivies de façon incrémentale.
+struct Replica {
+    Ising::Lattice lat;
+    double energy;
+    double magnetization;
+};
+
+Properties parallelTempering(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint replicas, uint rounds, uint stepsPerRound, ExchangeStats &stats) {
+    assert(replicas > 1 && Ti > 0 && Tf > 0);
+
+    Properties props = properties(replicas);
+    stats.attempts = new double[replicas - 1]();
+    stats.accepted = new double[replicas - 1]();
+
+    // * Echelle géométrique : des températures plus serrées à basse température, où les distributions d'énergie sont étroites.
+    const double Tmin = std::min(Ti, Tf);
+    const double ratio = std::pow(std::max(Ti, Tf) / Tmin, 1.0 / (replicas - 1));
+
+    std::vector<Replica> replica(replicas);
+    std::vector<Parameters> local(replicas, options);
+    std::vector<uint> slot(replicas);
+
+    for (uint k = 0; k < replicas; k++) {
+        local[k].T = Tmin * std::pow(ratio, k);
+        local[k].threads = 1;
+
+        replica[k].lat = Ising::copyLattice(lat);
+        Ising::seed(replica[k].lat, options.seed, k + 1);
+        replica[k].energy = Ising::latticeEnergy(replica[k].lat, local[k].J, local[k].h);
+        replica[k].magnetization = Ising::magnetization(replica[k].lat);
+        slot[k] = k;
+
+        props.T[k] = local[k].T;
+        props.E[k] = 0;
+        props.E_sq[k] = 0;
+        props.M[k] = 0;
+        props.M_sq[k] = 0;
+        props.M_abs[k] = 0;
+        props.mcSteps[k] = (double)rounds * stepsPerRound;
+        props.samples[k] = props.mcSteps[k];
+    }
+
+    // * Mise à l'équilibre initiale de chaque réplique à sa température.
+    Parallel::forEach(replicas, options.threads, [&](uint k, uint worker) {
+        Replica &r = replica[slot[k]];
+        std::cout << ("[PT] Equilibrating T = " + std::to_string(local[k].T) + "\n");
+        reachEquilibrium(r.lat, local[k], r.energy, r.magnetization);
+    });
+
+    RNG::Generator exchange = RNG::generator(options.seed, replicas + 1);
+
+    // * Un tour ne dure que stepsPerRound itérations : les threads sont créés une fois pour tous les tours,
+    // * le worker w prenant les températures w, w + size, ...
+    Parallel::Team team(std::max(1u, std::min(options.threads, replicas)));
+
+    for (uint round = 0; round < rounds; round++) {
+        // * slot[k] est la réplique actuellement à la température k : chaque tâche n'écrit que dans le point k.
+        team.run([&](uint worker) {
+            for (uint k = worker; k < replicas; k += team.size()) {
+                Replica &r = replica[slot[k]];
+                double deltaE = 0;
+                double deltaM = 0;
+
+                for (uint j = 0; j < stepsPerRound; j++) {
+                    props.E[k] += r.energy;
+                    props.E_sq[k] += r.energy * r.energy;
+                    props.M[k] += r.magnetization;
+                    props.M_sq[k] += r.magnetization * r.magnetization;
+                    props.M_abs[k] += fabs(r.magnetization);
+
+                    local[k].mcIterator(r.lat, local[k], deltaE, deltaM);
+                    r.energy += deltaE;
+                    r.magnetization += deltaM;
+                }
+            }
+        });
+
+        for (uint k = round % 2; k + 1 < replicas; k += 2) {
+            const double betaA = 1 / (options.kB * local[k].T);
+            const double betaB = 1 / (options.kB * local[k + 1].T);
+            const double delta = (betaA - betaB) * (replica[slot[k]].energy - replica[slot[k + 1]].energy);
+
+            stats.attempts[k]++;
+            if (delta >= 0 || RNG::uniform(exchange) < std::exp(delta)) {
+                std::swap(slot[k], slot[k + 1]);
+                stats.accepted[k]++;
+            }
+        }
+    }
+
+    for (uint k = 0; k + 1 < replicas; k++) {
+        std::cout << "[PT] Exchange T = " << local[k].T << " <-> " << local[k + 1].T << " : " << stats.accepted[k] / std::max(1.0, stats.attempts[k]) << "\n";
+    }
+
+    for (Replica &r : replica) {
+        Ising::freeLattice(r.lat);
+    }
+    return props;
+}
+}
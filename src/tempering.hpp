@@ -0,0 +1,34 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+// Echange de répliques (parallel tempering) : plusieurs copies du réseau évoluent simultanément sur une échelle
+// de températures et échangent périodiquement leurs configurations entre températures voisines.
+
+namespace MC {
+
+/// @brief Statistiques d'échange entre les températures k et k + 1 (replicas - 1 entrées).
+struct ExchangeStats {
+    double *attempts;
+    double *accepted;
+};
+
+/// @brief Echange de répliques sur une échelle géométrique de températures entre Ti et Tf.
+/// Chaque réplique est une copie de lat avec son propre flux aléatoire (options.seed, réplique + 1) ; elles sont
+/// d'abord amenées à l'équilibre par reachEquilibrium, puis chaque tour consiste en stepsPerRound itérations de
+/// options.mcIterator par réplique (réparties sur une équipe persistante de options.threads threads) suivies de tentatives d'échange
+/// entre températures voisines (paires paires et impaires en alternance), acceptées avec la probabilité
+/// min(1, exp((β_k - β_k+1)(E_k - E_k+1))). Les grandeurs moyennes sont accumulées par température, comme
+/// dans thermalizeLattice. lat n'est pas modifié.
+/// @param lat Réseau de spin de départ
+/// @param options Paramètres de simulation
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param replicas Nombre de répliques (et de températures)
+/// @param rounds Nombre de tours de mesure
+/// @param stepsPerRound Nombre d'itérations Monte-Carlo entre deux tentatives d'échange
+/// @param stats Statistiques d'échange (allouées par la fonction)
+/// @return Propriétés par température
+Properties parallelTempering(Ising::Lattice &lat, Parameters &options, double Ti, double Tf, uint replicas, uint rounds, uint stepsPerRound, ExchangeStats &stats);
+}
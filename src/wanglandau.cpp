@@ -0,0 +1,319 @@
+#include "wanglandau.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace WangLandau {
+
+/// @brief Nombre maximal de balayages pour amener un marcheur dans sa fenêtre.
+#define WINDOW_SEARCH_SWEEPS 10000
+
+/// @brief Marcheur d'une fenêtre [low, high] d'indices d'énergie, avec ses propres ln g et histogramme.
+struct Walker {
+    Ising::Lattice lat;
+    uint low;
+    uint high;
+    uint bin;
+    double magnetization;
+
+    std::vector<double> logG;
+    std::vector<double> histogram;
+    std::vector<bool> visited;
+    // Sommes de M, M², |M| et nombre de mesures par énergie, hors première étape
+    std::vector<double> M;
+    std::vector<double> M_sq;
+    std::vector<double> M_abs;
+    std::vector<double> samples;
+
+    double lnf;
+    bool inverse;
+    uint stage;
+    double steps;
+    bool done;
+};
+
+Parameters parameters(double lnfFinal, uint windows, double J, uint64_t seed) {
+    Parameters params = Parameters();
+    params.flatness = 0.8;
+    params.lnfInitial = 1;
+    params.lnfFinal = lnfFinal;
+    params.inverseTime = true;
+    params.checkInterval = 100;
+    params.windows = std::max(1u, windows);
+    params.overlap = 0.25;
+    params.J = J;
+    params.seed = seed;
+    params.threads = 1;
+    return params;
+}
+
+static inline int field(const Ising::Lattice &lat, const uint site) {
+    return lat.neighbor != nullptr ? Ising::localField(lat, site) : Ising::hypercubeField(lat, site);
+}
+
+/// @brief Indice d'énergie d'une configuration : nombre de liaisons (Σ s_i s_j + bonds) / 2.
+static uint energyBin(Ising::Lattice &lat, const uint bonds) {
+    const int64_t sum = std::llround(-Ising::latticeEnergy(lat, 1, 0));
+    return (sum + bonds) / 2;
+}
+
+/// @brief Distance d'un indice d'énergie à la fenêtre du marcheur.
+static uint distance(const Walker &w, const uint bin) {
+    return bin < w.low ? w.low - bin : bin > w.high ? bin - w.high : 0;
+}
+
+/// @brief Amène le marcheur dans sa fenêtre : un retournement est gardé s'il ne l'en éloigne pas.
+static bool enterWindow(Walker &w) {
+    const double limit = (double)WINDOW_SEARCH_SWEEPS * w.lat.siteCount;
+    for (double step = 0; distance(w, w.bin) > 0 && step < limit; step++) {
+        const uint site = RNG::bounded(w.lat.rng, w.lat.siteCount);
+        const int spin = w.lat.spin[site];
+        const uint next = w.bin - spin * field(w.lat, site);
+        if (distance(w, next) <= distance(w, w.bin)) {
+            w.lat.spin[site] = -spin;
+            w.magnetization -= 2 * spin;
+            w.bin = next;
+        }
+    }
+    return distance(w, w.bin) == 0;
+}
+
+/// @brief Marche de Wang-Landau pendant un nombre de balayages donné.
+static void walk(Walker &w, const uint sweeps) {
+    Ising::Lattice &lat = w.lat;
+    const double count = (double)sweeps * lat.siteCount;
+
+    for (double step = 0; step < count; step++) {
+        const uint site = RNG::bounded(lat.rng, lat.siteCount);
+        const int spin = lat.spin[site];
+        // * Retourner le site change le nombre de liaisons satisfaites de -spin * champ.
+        const uint next = w.bin - spin * field(lat, site);
+
+        if (next >= w.low && next <= w.high) {
+            const double ratio = w.logG[w.bin - w.low] - w.logG[next - w.low];
+            if (ratio >= 0 || RNG::uniform(lat.rng) < std::exp(ratio)) {
+                lat.spin[site] = -spin;
+                w.magnetization -= 2 * spin;
+                w.bin = next;
+            }
+        }
+
+        const uint b = w.bin - w.low;
+        w.logG[b] += w.lnf;
+        w.histogram[b]++;
+        w.visited[b] = true;
+        if (w.stage > 0) {
+            w.M[b] += w.magnetization;
+            w.M_sq[b] += w.magnetization * w.magnetization;
+            w.M_abs[b] += fabs(w.magnetization);
+            w.samples[b]++;
+        }
+    }
+    w.steps += count;
+}
+
+/// @brief Test de platitude de l'histogramme et réduction de ln f.
+static void refine(Walker &w, const Parameters &params) {
+    const double sweeps = w.steps / w.lat.siteCount;
+    if (w.inverse) {
+        w.lnf = 1 / sweeps;
+    }
+    else {
+        double minimum = INFINITY;
+        double sum = 0;
+        uint visited = 0;
+        for (size_t b = 0; b < w.histogram.size(); b++) {
+            if (w.visited[b]) {
+                minimum = std::min(minimum, w.histogram[b]);
+                sum += w.histogram[b];
+                visited++;
+            }
+        }
+        if (visited == 0 || minimum < params.flatness * sum / visited) {
+            return;
+        }
+
+        std::fill(w.histogram.begin(), w.histogram.end(), 0);
+        w.stage++;
+        w.lnf /= 2;
+        if (params.inverseTime && w.lnf < 1 / sweeps) {
+            w.inverse = true;
+            w.lnf = 1 / sweeps;
+        }
+    }
+    w.done = w.lnf < params.lnfFinal;
+}
+
+/// @brief Tentative d'échange des configurations de deux fenêtres voisines dont les énergies sont dans le recouvrement.
+static void exchange(Walker &a, Walker &b, RNG::Generator &rng) {
+    if (a.done || b.done || a.bin < b.low || a.bin > b.high || b.bin < a.low || b.bin > a.high) {
+        return;
+    }
+    const double logRatio = a.logG[a.bin - a.low] + b.logG[b.bin - b.low] - a.logG[b.bin - a.low] - b.logG[a.bin - b.low];
+    if (logRatio >= 0 || RNG::uniform(rng) < std::exp(logRatio)) {
+        std::swap(a.lat.spin, b.lat.spin);
+        std::swap(a.bin, b.bin);
+        std::swap(a.magnetization, b.magnetization);
+    }
+}
+
+DensityOfStates estimate(const Ising::Lattice &lat, const Parameters &params) {
+    const uint bonds = lat.siteCount * lat.dimension;
+    const uint bins = bonds + 1;
+    const uint windows = std::min(params.windows, bins);
+
+    // * Fenêtres de largeur égale, chacune recouvrant la suivante d'une fraction overlap de sa largeur.
+    const double width = bins / (windows - (windows - 1) * params.overlap);
+    std::vector<Walker> walkers(windows);
+    for (uint k = 0; k < windows; k++) {
+        Walker &w = walkers[k];
+        w.low = std::floor(k * width * (1 - params.overlap));
+        w.high = k + 1 == windows ? bins - 1 : std::min<uint>(bins - 1, std::ceil(w.low + width) - 1);
+        const uint size = w.high - w.low + 1;
+        w.logG.assign(size, 0);
+        w.histogram.assign(size, 0);
+        w.visited.assign(size, false);
+        w.M.assign(size, 0);
+        w.M_sq.assign(size, 0);
+        w.M_abs.assign(size, 0);
+        w.samples.assign(size, 0);
+        w.lnf = params.lnfInitial;
+
+        w.lat = Ising::copyLattice(lat);
+        Ising::seed(w.lat, params.seed, k + 1);
+        w.bin = energyBin(w.lat, bonds);
+        w.magnetization = Ising::magnetization(w.lat);
+    }
+
+    Parallel::forEach(windows, params.threads, [&](uint k, uint worker) {
+        if (!enterWindow(walkers[k])) {
+            std::cerr << ("[WangLandau] Window " + std::to_string(k) + " not reached, skipped\n");
+            walkers[k].done = true;
+        }
+    });
+
+    // * Threads créés une fois pour tous les tours de checkInterval balayages, le worker t prenant les fenêtres t, t + size, ...
+    Parallel::Team team(std::max(1u, std::min(params.threads, windows)));
+    RNG::Generator rng = RNG::generator(params.seed, windows + 1);
+    uint running = windows;
+    for (uint round = 0; running > 0; round++) {
+        team.run([&](uint worker) {
+            for (uint k = worker; k < windows; k += team.size()) {
+                Walker &w = walkers[k];
+                if (!w.done) {
+                    walk(w, params.checkInterval);
+                    refine(w, params);
+                }
+            }
+        });
+
+        // * Paires paires puis impaires en alternance, comme l'échange de répliques en température.
+        for (uint k = round % 2; k + 1 < windows; k += 2) {
+            exchange(walkers[k], walkers[k + 1], rng);
+        }
+
+        running = 0;
+        for (const Walker &w : walkers) {
+            running += !w.done;
+        }
+        if (round % 100 == 0) {
+            std::cout << "[WangLandau] " << running << " window(s) running, ln f = " << walkers[0].lnf << "\n";
+        }
+    }
+
+    // * Recollement : chaque fenêtre est décalée pour coïncider en moyenne avec les précédentes sur leur recouvrement,
+    // * et fait foi à partir du milieu de celui-ci.
+    DensityOfStates dos = DensityOfStates();
+    dos.J = params.J;
+    dos.bonds = bonds;
+    dos.logG.assign(bins, -INFINITY);
+    dos.M.assign(bins, 0);
+    dos.M_sq.assign(bins, 0);
+    dos.M_abs.assign(bins, 0);
+    std::vector<double> samples(bins, 0);
+
+    uint previousHigh = 0;
+    for (uint k = 0; k < windows; k++) {
+        const Walker &w = walkers[k];
+        double offset = 0;
+        uint shared = 0;
+        for (uint b = w.low; b <= w.high; b++) {
+            if (w.visited[b - w.low] && std::isfinite(dos.logG[b])) {
+                offset += dos.logG[b] - w.logG[b - w.low];
+                shared++;
+            }
+        }
+        offset = shared > 0 ? offset / shared : 0;
+        const uint from = k == 0 ? w.low : (w.low + previousHigh + 1) / 2;
+
+        for (uint b = w.low; b <= w.high; b++) {
+            if (w.visited[b - w.low] && (b >= from || !std::isfinite(dos.logG[b]))) {
+                dos.logG[b] = w.logG[b - w.low] + offset;
+            }
+            dos.M[b] += w.M[b - w.low];
+            dos.M_sq[b] += w.M_sq[b - w.low];
+            dos.M_abs[b] += w.M_abs[b - w.low];
+            samples[b] += w.samples[b - w.low];
+        }
+        previousHigh = w.high;
+        dos.steps += w.steps;
+        Ising::freeLattice(walkers[k].lat);
+    }
+
+    // * Deux états fondamentaux (tous les spins alignés) : ln g = ln 2 pour la dernière énergie.
+    const double shift = std::isfinite(dos.logG[bins - 1]) ? std::log(2.0) - dos.logG[bins - 1] : 0;
+    for (uint b = 0; b < bins; b++) {
+        dos.logG[b] += shift;
+        if (samples[b] > 0) {
+            dos.M[b] /= samples[b];
+            dos.M_sq[b] /= samples[b];
+            dos.M_abs[b] /= samples[b];
+        }
+    }
+    return dos;
+}
+
+MC::Properties thermodynamics(const DensityOfStates &dos, double kB, double Ti, double Tf, uint samplingPoints) {
+    assert(samplingPoints > 1);
+    MC::Properties props = MC::properties(samplingPoints);
+    const double dT = (Tf - Ti) / (samplingPoints - 1);
+    const uint bins = dos.logG.size();
+    std::vector<double> logWeight(bins);
+
+    for (uint i = 0; i < samplingPoints; i++) {
+        const double T = Ti + i * dT;
+        const double beta = 1 / (kB * T);
+
+        // * Log-sum-exp : ln g(E) - βE dépasse largement le domaine de exp pour les grands réseaux.
+        double top = -INFINITY;
+        for (uint b = 0; b < bins; b++) {
+            logWeight[b] = dos.logG[b] - beta * energy(dos, b);
+            top = std::max(top, logWeight[b]);
+        }
+        double Z = 0, E = 0, E_sq = 0, M = 0, M_sq = 0, M_abs = 0;
+        for (uint b = 0; b < bins; b++) {
+            const double w = std::exp(logWeight[b] - top);
+            const double e = energy(dos, b);
+            Z += w;
+            E += w * e;
+            E_sq += w * e * e;
+            M += w * dos.M[b];
+            M_sq += w * dos.M_sq[b];
+            M_abs += w * dos.M_abs[b];
+        }
+
+        props.T[i] = T;
+        props.E[i] = E / Z;
+        props.E_sq[i] = E_sq / Z;
+        props.M[i] = M / Z;
+        props.M_sq[i] = M_sq / Z;
+        props.M_abs[i] = M_abs / Z;
+        props.samples[i] = 1;
+        props.mcSteps[i] = dos.steps;
+    }
+    return props;
+}
+}
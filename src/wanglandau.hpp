@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ising.hpp"
+#include "montecarlo.hpp"
+
+#include <vector>
+
+// Algorithme de Wang-Landau : une marche aléatoire en énergie, acceptée avec min(1, g(E) / g(E')), estime la densité
+// d'états g(E) en augmentant ln g de ln f à chaque pas. Quand l'histogramme des énergies visitées est plat, ln f est
+// divisé par deux (ou suit 1/t, voir Parameters::inverseTime) jusqu'à lnfFinal. Les énergies peuvent être découpées en
+// fenêtres qui se recouvrent, chacune parcourue par son propre marcheur en parallèle, avec échange de configurations
+// entre fenêtres voisines. Toutes les grandeurs moyennes à toute température se déduisent ensuite de g(E).
+// ! Champ nul uniquement : g(E) porte sur l'énergie d'échange -J Σ s_i s_j.
+
+namespace WangLandau {
+
+/// @brief Paramètres d'une estimation de densité d'états.
+struct Parameters {
+    // Un histogramme est plat quand son minimum atteint flatness fois sa moyenne (sur les énergies déjà visitées)
+    double flatness;
+    double lnfInitial;
+    double lnfFinal;
+    // Passage à ln f = 1/t (t en balayages) dès que ln f / 2 passerait sous 1/t : évite la saturation de l'erreur
+    bool inverseTime;
+    // Balayages entre deux tests de platitude, et entre deux tentatives d'échange entre fenêtres
+    uint checkInterval;
+    uint windows;
+    // Fraction de la largeur d'une fenêtre partagée avec la suivante
+    double overlap;
+
+    double J;
+    uint64_t seed;
+    uint threads;
+};
+
+/// @brief Paramètres par défaut (platitude 0.8, ln f de 1 à lnfFinal par divisions par deux puis en 1/t,
+/// test tous les 100 balayages, un thread).
+/// @param lnfFinal Valeur finale de ln f
+/// @param windows Nombre de fenêtres d'énergie (1 : une seule marche sur tout le spectre)
+/// @param J Paramètre de couplage
+/// @param seed Graine
+Parameters parameters(double lnfFinal, uint windows, double J, uint64_t seed);
+
+/// @brief Densité d'états estimée, indexée par le nombre de liaisons : l'énergie b est -J (2b - bonds).
+struct DensityOfStates {
+    double J;
+    uint bonds;
+    // ln g(E), normalisé pour que g vaille 2 dans l'état fondamental (-INFINITY pour une énergie jamais visitée)
+    std::vector<double> logG;
+    // Moyennes microcanoniques de M, M² et |M| à chaque énergie
+    std::vector<double> M;
+    std::vector<double> M_sq;
+    std::vector<double> M_abs;
+    // Nombre total de pas de la marche, toutes fenêtres confondues
+    double steps;
+};
+
+/// @brief Energie d'un indice de la densité d'états.
+inline double energy(const DensityOfStates &dos, const uint bin) {
+    return - dos.J * (2.0 * bin - dos.bonds);
+}
+
+/// @brief Estime la densité d'états d'un réseau de la taille et de la géométrie de lat (1D, 2D ou hypercubique).
+/// Chaque fenêtre part d'une copie de lat, amenée dans la fenêtre par des retournements qui ne l'en éloignent pas.
+/// Les fenêtres sont recollées en décalant ln g pour qu'il coïncide en moyenne sur leur recouvrement. lat n'est pas modifié.
+/// @param lat Réseau de spin de départ
+/// @param params Paramètres de l'estimation
+/// @return Densité d'états
+DensityOfStates estimate(const Ising::Lattice &lat, const Parameters &params);
+
+/// @brief Grandeurs moyennes canoniques sur une grille de températures, déduites de g(E) sans nouvelle simulation.
+/// @param dos Densité d'états
+/// @param kB Constante de Boltzmann
+/// @param Ti Température de départ
+/// @param Tf Température de fin
+/// @param samplingPoints Nombre de points
+/// @return Propriétés à une mesure par point (mêmes colonnes que saveProps), mcSteps contenant le nombre de pas de la marche
+MC::Properties thermodynamics(const DensityOfStates &dos, double kB, double Ti, double Tf, uint samplingPoints);
+}